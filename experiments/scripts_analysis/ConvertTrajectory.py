@@ -0,0 +1,63 @@
+import csv
+import math
+import struct
+import sys
+from array import array
+
+# Converts a trajectory file written with --trajectory (blocks of columns, see src/population/trajectory.hpp) to csv,
+# one line per recorded generation with the columns seed,n,m,mu,run,generations,diversity,fitness,unique,algorithm,mutation(,alpha)
+# Generations recorded twice (runs resumed from a checkpoint) are kept once, with their last recorded values
+
+MAGIC = b"EDO-TRAJECTORY1\0"
+
+def read_blocks(input_file):
+    with open(input_file, "rb") as file:
+        data = file.read()
+    offset = 0
+    while offset < len(data):
+        if data[offset:offset + 16] != MAGIC:
+            raise ValueError(f"Invalid trajectory block at byte {offset} of {input_file}")
+        offset += 16
+        seed, n, m, mu, run, alpha = struct.unpack_from("=5id", data, offset)
+        offset += struct.calcsize("=5id")
+        texts = []
+        for _ in range(2):
+            (length,) = struct.unpack_from("=I", data, offset)
+            offset += 4
+            texts.append(data[offset:offset + length].decode())
+            offset += length
+        (count,) = struct.unpack_from("=I", data, offset)
+        offset += 4
+        columns = []
+        for typecode in ["i", "d", "d", "i"]:
+            column = array(typecode)
+            column.frombytes(data[offset:offset + count * column.itemsize])
+            offset += count * column.itemsize
+            columns.append(column)
+        yield {"seed": seed, "n": n, "m": m, "mu": mu, "run": run, "alpha": alpha,
+               "algorithm": texts[0], "mutation": texts[1], "columns": columns}
+
+def convert_trajectory(input_file, output_file):
+    points = {}
+    for block in read_blocks(input_file):
+        alpha = "" if math.isnan(block["alpha"]) else block["alpha"]
+        key = (block["seed"], block["n"], block["m"], block["mu"], block["run"], block["algorithm"], block["mutation"], alpha)
+        for generation, diversity, fitness, unique in zip(*block["columns"]):
+            points[key + (generation,)] = (diversity, fitness, unique)
+    with_alpha = any(key[7] != "" for key in points)
+    with open(output_file, "w", newline="") as file:
+        writer = csv.writer(file)
+        writer.writerow(["seed", "n", "m", "mu", "run", "generations", "diversity", "fitness", "unique", "algorithm", "mutation"] + (["alpha"] if with_alpha else []))
+        for key in sorted(points, key=lambda key: key[:7] + (str(key[7]), key[8])):
+            seed, n, m, mu, run, algorithm, mutation, alpha, generation = key
+            diversity, fitness, unique = points[key]
+            writer.writerow([seed, n, m, mu, run, generation, diversity, fitness, unique, algorithm, mutation] + ([alpha] if with_alpha else []))
+
+
+if(__name__ == "__main__"):
+
+    if len(sys.argv) < 3:
+        print("Usage: python3 ConvertTrajectory.py <input_file> <output_file>")
+        exit(1)
+
+    convert_trajectory(sys.argv[1], sys.argv[2])
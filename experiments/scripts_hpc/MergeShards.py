@@ -0,0 +1,105 @@
+import sys
+import argparse
+
+# Merges the csv outputs of the shards of one experiment (--shard-index / --shard-count) into a single file,
+# checking that they share their header, contain only complete rows and no result twice,
+# and, if the grid is given, that every viable run of it is present
+
+def parse_list(string, type):
+    return [type(value) for value in string.split(",")]
+
+def generate_seed(mu, n, m, run):
+    return n*mu*mu+n*run*run+n+m*run+m*m+run
+
+def is_viable_combination(mu, n, m):
+    return (m < n) and (mu <= (n*n - n)//(n-m))
+
+def expected_keys(runs, mus, ns, ms, alphas):
+    keys = set()
+    for n in ns:
+        for mu in mus:
+            for m in ms:
+                if(not is_viable_combination(mu, n, m)): continue
+                for run in range(runs):
+                    key = (str(generate_seed(mu, n, m, run)), str(n), str(m), str(mu), str(run))
+                    if(alphas is None):
+                        keys.add(key)
+                    else:
+                        for alpha in alphas:
+                            keys.add(key + (float(alpha),))
+    return keys
+
+def merge_shards(shard_files, output_file, grid):
+    errors = []
+    header = None
+    rows = []
+    keys = set()
+    for shard_file in shard_files:
+        with open(shard_file, 'r') as file:
+            content = file.read()
+        if(content and not content.endswith("\n")):
+            errors.append(f"{shard_file}: last line is incomplete")
+        lines = content.splitlines()
+        if(not lines):
+            errors.append(f"{shard_file}: empty")
+            continue
+        if(header is None):
+            header = lines[0]
+        elif(lines[0] != header):
+            errors.append(f"{shard_file}: header differs from {shard_files[0]}")
+            continue
+        columns = header.split(",")
+        key_columns = [columns.index(column) for column in ["seed", "n", "m", "mu", "run", "alpha"] if column in columns]
+        for number, line in enumerate(lines[1:], start=2):
+            values = line.split(",")
+            if(len(values) != len(columns)):
+                errors.append(f"{shard_file}:{number}: {len(values)} columns instead of {len(columns)}")
+                continue
+            key = tuple(float(values[i]) if columns[i] == "alpha" else values[i] for i in key_columns)
+            if(key in keys):
+                errors.append(f"{shard_file}:{number}: duplicate result {key}")
+                continue
+            keys.add(key)
+            rows.append(line)
+
+    if(grid is not None and header is not None):
+        alphas = grid.alphas.split(",") if "alpha" in header.split(",") else None
+        expected = expected_keys(grid.runs, parse_list(grid.mus, int), parse_list(grid.ns, int), parse_list(grid.ms, int), alphas)
+        for key in sorted(expected - keys):
+            errors.append(f"missing result {key}")
+        for key in sorted(keys - expected):
+            errors.append(f"unexpected result {key}")
+
+    if(errors):
+        for error in errors:
+            print(error)
+        print(f"Validation failed with {len(errors)} errors, {output_file} not written.")
+        return False
+
+    with open(output_file, 'w') as output:
+        output.write(header + "\n")
+        for row in rows:
+            output.write(row + "\n")
+    print(f"Merged {len(rows)} results from {len(shard_files)} shards.")
+    return True
+
+if(__name__ == "__main__"):
+
+    parser = argparse.ArgumentParser(description="Merge and validate the outputs of the shards of an experiment.")
+    parser.add_argument("output_file")
+    parser.add_argument("shard_files", nargs="+")
+    parser.add_argument("--runs", type=int, help="runs of the grid, checks that no result is missing (with --mus, --ns, --ms)")
+    parser.add_argument("--mus")
+    parser.add_argument("--ns")
+    parser.add_argument("--ms")
+    parser.add_argument("--alphas", default="-", help="alphas as passed to Bachelor_Thesis (for Mu1-const)")
+    args = parser.parse_args()
+
+    grid = None
+    if(args.runs is not None):
+        if(args.mus is None or args.ns is None or args.ms is None):
+            parser.error("--runs requires --mus, --ns and --ms")
+        grid = args
+
+    if(not merge_shards(args.shard_files, args.output_file, grid)):
+        sys.exit(1)
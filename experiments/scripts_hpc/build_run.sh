@@ -3,4 +3,4 @@ mkdir -p build
 cd build
 cmake ..
 make
-./Bachelor_Thesis $1 $2 $3 $4 $5 $6 $7 $8 $9
\ No newline at end of file
+./Bachelor_Thesis "$@"
\ No newline at end of file
@@ -7,7 +7,17 @@
 #SBATCH --mem-per-cpu=50M
 
 #SBATCH --job-name=JOB_NAME
-#SBATCH --output=output_JOB_NAME.txt
+#SBATCH --output=output_JOB_NAME_%a.txt
 #SBATCH --time=WALL_TIME
+#SBATCH --array=0-SHARD_MAX
 
-sh build_run.sh $1 $2 $3 $4 $5 $6 $7 $8 $9
\ No newline at end of file
+# every array task runs one shard of the grid, merge the shard outputs with MergeShards.py
+# the binary is built once by start_experiment.sh before submitting, the tasks share the build directory and only run it
+SHARD_INDEX=${SLURM_ARRAY_TASK_ID:-0}
+OUTPUT_FILE=$3
+if [ SHARD_COUNT -gt 1 ]; then
+    OUTPUT_FILE=${3%.csv}_shard$SHARD_INDEX.csv
+fi
+
+cd ../../build
+./Bachelor_Thesis $1 $2 $OUTPUT_FILE $4 $5 $6 $7 $8 $9 --shard-index=$SHARD_INDEX --shard-count=SHARD_COUNT
\ No newline at end of file
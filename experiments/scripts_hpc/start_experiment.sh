@@ -3,17 +3,22 @@
 start_job() {
     JOB_NAME=$2_$3_a${8//./}_l${9//./}
     OUTPUT_FILE=output_$JOB_NAME.csv
-    sed "s/JOB_NAME/$JOB_NAME/g; s/WALL_TIME/$1/g" job_template.sh > temp_job.sh
+    sed "s/JOB_NAME/$JOB_NAME/g; s/WALL_TIME/$1/g; s/SHARD_COUNT/$SHARDS/g; s/SHARD_MAX/$((SHARDS - 1))/g" job_template.sh > temp_job.sh
     sbatch temp_job.sh $2 $3 $OUTPUT_FILE $4 $5 $6 $7 $8 $9
     sleep 10
     rm temp_job.sh
 }
 
-if [ "$#" -ne 9 ]; then
-    echo "Usage: $0 <walltime> <algorithm> <mutation_operator> <runs> <mus> <ns> <ms> <alphas> <lambdas>"
+if [ "$#" -ne 9 ] && [ "$#" -ne 10 ]; then
+    echo "Usage: $0 <walltime> <algorithm> <mutation_operator> <runs> <mus> <ns> <ms> <alphas> <lambdas> [<shards>]"
     exit 1
 fi
 
+SHARDS=${10:-1}
+
+# build once before submitting, so the tasks of the array job do not run cmake and make concurrently in the shared build directory
+(cd ../../ && mkdir -p build && cd build && cmake .. && make) || exit 1
+
 for alpha in $8; do
     for lambda in $9; do
         start_job $1 $2 $3 $4 $5 $6 $7 $alpha $lambda
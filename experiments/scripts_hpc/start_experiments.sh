@@ -6,6 +6,7 @@ ms="1,3,5,10"
 runs="30"
 
 wall_time="7-00:00:00"
+shards="1"
 
 alphas="0.1 0.3 0.6"
 lambdas="0.1 0.2 2" 
@@ -27,7 +28,7 @@ for algorithm in "${algorithms[@]}"; do
         elif [ "$mutation_operator" == "NSWAP" ]; then
             current_ms="1"
         fi
-        ./start_experiment.sh "$wall_time" "$algorithm" "$mutation_operator" "$runs" "$mus" "$ns" "$current_ms" "$current_alpha" "$current_lambdas"
+        ./start_experiment.sh "$wall_time" "$algorithm" "$mutation_operator" "$runs" "$mus" "$ns" "$current_ms" "$current_alpha" "$current_lambdas" "$shards"
     done
 done
 
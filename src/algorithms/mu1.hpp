@@ -2,6 +2,7 @@
 
 #include "../population/population.hpp"
 #include "../population/population_mu1.hpp"
+#include "../population/population_static.hpp"
 #include "../operators/operators_initialization.hpp"
 #include "../operators/operators_evaluation.hpp"
 #include "../operators/operators_parentSelection.hpp"
@@ -13,71 +14,205 @@
 using T = std::vector<std::vector<int>>;
 using L = double;
 
-Population<T,L> mu1_unconstrained_unoptimized(
+template <typename G = T>
+Population<G,L> mu1_unconstrained_unoptimized(
     int seed, 
     int m, 
     int n, 
     int mu,
-    std::function<bool(Population<T,L>&)> termination_criterion,
-    std::function<std::vector<L>(const std::vector<T>&)> evaluate,
-    std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> mutate,
-    std::function<double(const T&, const T&)> diversity_measure
+    std::function<bool(Population<G,L>&)> termination_criterion,
+    std::function<std::vector<L>(const std::vector<G>&)> evaluate,
+    std::function<std::vector<G>(const std::vector<G>&, std::mt19937&)> mutate,
+    std::function<double(const G&, const G&)> diversity_measure
 ){
 
-    std::function<std::vector<T>(std::mt19937&)> initialize = initialize_random(mu, n, m);
-    std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> recombine = nullptr;
-    std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, std::mt19937&)> select_parents = select_random(1);
-    std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const std::vector<T>&, std::mt19937&)> select_survivors = select_div(diversity_measure);
+    std::function<std::vector<G>(std::mt19937&)> initialize = initialize_random<G>(mu, n, m);
+    std::function<std::vector<G>(const std::vector<G>&, std::mt19937&)> recombine = nullptr;
+    std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, std::mt19937&)> select_parents = select_random<G>(1);
+    std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, const std::vector<G>&, std::mt19937&)> select_survivors = select_div(diversity_measure);
 
-    Population<T, L> population(seed, initialize, evaluate, select_parents, mutate, recombine, select_survivors);
+    Population<G, L> population(seed, initialize, evaluate, select_parents, mutate, recombine, select_survivors);
+    population.set_consumes_fitness(false);
     population.execute(termination_criterion);
     return population;
 }
 
-Population_Mu1<T,L> mu1_unconstrained(
+template <typename G = T>
+Population_Mu1<G,L> mu1_unconstrained(
     int seed, 
     int m, 
     int n, 
     int mu,
-    std::function<bool(Population<T,L>&)> termination_criterion,
-    std::function<std::vector<L>(const std::vector<T>&)> evaluate,
-    std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> mutate,
-    std::function<double(const T&, const T&)> diversity_measure
+    std::function<bool(Population<G,L>&)> termination_criterion,
+    std::function<std::vector<L>(const std::vector<G>&)> evaluate,
+    std::function<std::vector<G>(const std::vector<G>&, std::mt19937&)> mutate,
+    std::function<double(const G&, const G&)> diversity_measure
 ){
 
-    std::function<std::vector<T>(std::mt19937&)> initialize = initialize_random(mu, n, m);
-    std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> recombine = nullptr;
-    std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, std::mt19937&)> select_parents = select_random(1);
-    std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const std::vector<T>&, std::mt19937&)> select_survivors = nullptr;
-    std::function<Diversity_Preserver<T>(const std::vector<T>&, const T&, const Diversity_Preserver<T>&, std::mt19937&)> selectSurvivors_Div = select_pdiv(diversity_measure);
+    std::function<std::vector<G>(std::mt19937&)> initialize = initialize_random<G>(mu, n, m);
+    std::function<std::vector<G>(const std::vector<G>&, std::mt19937&)> recombine = nullptr;
+    std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, std::mt19937&)> select_parents = select_random<G>(1);
+    std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, const std::vector<G>&, std::mt19937&)> select_survivors = nullptr;
+    std::function<void(std::vector<G>&, const G&, Diversity_Preserver<G>&, std::mt19937&)> selectSurvivors_Div = select_pdiv(diversity_measure);
 
-    Population_Mu1<T, L> population(seed, initialize, evaluate, select_parents, mutate, recombine, select_survivors, selectSurvivors_Div);
+    Population_Mu1<G, L> population(seed, initialize, evaluate, select_parents, mutate, recombine, select_survivors, selectSurvivors_Div);
+    population.set_consumes_fitness(false);
     population.execute(termination_criterion);
     return population;
 }
 
-Population_Mu1<T,L> mu1_constrained(
+template <typename G = T>
+Population_Mu1<G,L> mu1_constrained(
     int seed, 
     int m, 
     int n, 
     int mu,
-    std::function<bool(Population<T,L>&)> termination_criterion,
-    std::function<std::vector<L>(const std::vector<T>&)> evaluate,
-    std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> mutate,
-    std::function<double(const T&, const T&)> diversity_measure,
+    std::function<bool(Population<G,L>&)> termination_criterion,
+    std::function<std::vector<L>(const std::vector<G>&)> evaluate,
+    std::function<std::vector<G>(const std::vector<G>&, std::mt19937&)> mutate,
+    std::function<double(const G&, const G&)> diversity_measure,
     double alpha,
-    T initial_gene
+    G initial_gene
 ){
 
     double OPT = evaluate({initial_gene})[0];
 
-    std::function<std::vector<T>(std::mt19937&)> initialize = initialize_fixed(std::vector<T>(mu, initial_gene));
-    std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> recombine = nullptr;
-    std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, std::mt19937&)> select_parents =  select_random(1);
-    std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const std::vector<T>&, std::mt19937&)> select_survivors = nullptr;
-    std::function<Diversity_Preserver<T>(const std::vector<T>&, const T&, const Diversity_Preserver<T>&, std::mt19937&)> selectSurvivors_Div = select_qpdiv(alpha, n, OPT, diversity_measure, evaluate);
+    std::function<std::vector<G>(std::mt19937&)> initialize = initialize_fixed(std::vector<G>(mu, initial_gene));
+    std::function<std::vector<G>(const std::vector<G>&, std::mt19937&)> recombine = nullptr;
+    std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, std::mt19937&)> select_parents =  select_random<G>(1);
+    std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, const std::vector<G>&, std::mt19937&)> select_survivors = nullptr;
+    std::function<void(std::vector<G>&, const G&, Diversity_Preserver<G>&, std::mt19937&)> selectSurvivors_Div = select_qpdiv(alpha, n, OPT, diversity_measure, evaluate);
 
-    Population_Mu1<T,L> population(seed, initialize, evaluate, select_parents, mutate, recombine, select_survivors, selectSurvivors_Div);
+    Population_Mu1<G,L> population(seed, initialize, evaluate, select_parents, mutate, recombine, select_survivors, selectSurvivors_Div);
+    population.set_consumes_fitness(false);
     population.execute(termination_criterion);
     return population;
-}
\ No newline at end of file
+}
+
+/*
+    Delta variants: same algorithms for DFM, where the diversity scores of each offspring are derived from the scores of its parent and the edge changes reported by mutate
+    (and, for the constrained one, its fitness from the schedule of its parent and the machine positions changed by mutate)
+    If checkpoint_file is given, the run continues from the population saved in it (if it exists) and saves its population there periodically
+    If component_times is given, the time and calls of the components of the generations are added to it (since the last checkpoint)
+    With lambda > 1, every generation creates lambda offspring from random parents, which are selected in one batch (see pdiv_delta_batch:
+    pdiv-Selection applied lambda times, or with greedy lambda removals after all offspring joined), and the generations count the offspring,
+    so the generation budget stays comparable
+    If edge_diversity is given (see diversity_DFM_bitset), the scores are compared on preserved edge encodings instead of derived from the successor tables (only for lambda = 1)
+*/
+
+template <typename G = T>
+Population_Mu1<G,L> mu1_unconstrained_delta(
+    int seed, 
+    int m, 
+    int n, 
+    int mu,
+    std::function<bool(Population<G,L>&)> termination_criterion,
+    std::function<std::vector<L>(const std::vector<G>&)> evaluate,
+    std::function<void(const std::vector<G>&, std::vector<G>&, std::vector<Offspring_Delta>&, std::mt19937&)> mutate,
+    std::string checkpoint_file = "",
+    Component_Times* component_times = nullptr,
+    int lambda = 1,
+    bool greedy = false,
+    Edge_Diversity<G> edge_diversity = {}
+){
+
+    std::function<std::vector<G>(std::mt19937&)> initialize = initialize_random<G>(mu, n, m);
+    std::function<std::vector<G>(const std::vector<G>&, std::mt19937&)> no_mutate = nullptr;
+    std::function<std::vector<G>(const std::vector<G>&, std::mt19937&)> recombine = nullptr;
+    std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, std::mt19937&)> select_parents = nullptr;
+    std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, const std::vector<G>&, std::mt19937&)> select_survivors = nullptr;
+    std::function<void(std::vector<G>&, const G&, Diversity_Preserver<G>&, std::mt19937&)> selectSurvivors_Div = nullptr;
+
+    Population_Mu1<G, L> population(seed, initialize, evaluate, select_parents, no_mutate, recombine, select_survivors, selectSurvivors_Div);
+    population.set_consumes_fitness(false);
+    population.set_component_times(component_times);
+    population.set_selectParents_Index(select_random_indices<G>(lambda));
+    population.set_mutate_Delta(mutate);
+    population.set_selectSurvivors_Delta(edge_diversity.encode == nullptr ? select_pdiv_delta<G>() : select_pdiv_delta(edge_diversity));
+    if(lambda > 1) population.set_selectSurvivors_Batch(select_pdiv_batch<G>(greedy));
+    if(!checkpoint_file.empty()){
+        load_checkpoint(population, checkpoint_file);
+        termination_criterion = terminate_checkpointing<G>(termination_criterion, checkpoint_file);
+    }
+    population.execute(termination_criterion);
+    return population;
+}
+
+template <typename G = T>
+Population_Mu1<G,L> mu1_constrained_delta(
+    int seed, 
+    int m, 
+    int n, 
+    int mu,
+    std::function<bool(Population<G,L>&)> termination_criterion,
+    std::function<std::vector<L>(const std::vector<G>&)> evaluate,
+    Incremental_Evaluation<G> evaluate_incremental,
+    std::function<void(const std::vector<G>&, std::vector<G>&, std::vector<Offspring_Delta>&, std::mt19937&)> mutate,
+    double alpha,
+    G initial_gene,
+    std::string checkpoint_file = "",
+    Component_Times* component_times = nullptr,
+    int lambda = 1,
+    bool greedy = false,
+    Edge_Diversity<G> edge_diversity = {}
+){
+
+    double OPT = evaluate({initial_gene})[0];
+
+    std::function<std::vector<G>(std::mt19937&)> initialize = initialize_fixed(std::vector<G>(mu, initial_gene));
+    std::function<std::vector<G>(const std::vector<G>&, std::mt19937&)> no_mutate = nullptr;
+    std::function<std::vector<G>(const std::vector<G>&, std::mt19937&)> recombine = nullptr;
+    std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, std::mt19937&)> select_parents = nullptr;
+    std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, const std::vector<G>&, std::mt19937&)> select_survivors = nullptr;
+    std::function<void(std::vector<G>&, const G&, Diversity_Preserver<G>&, std::mt19937&)> selectSurvivors_Div = nullptr;
+
+    Population_Mu1<G,L> population(seed, initialize, evaluate, select_parents, no_mutate, recombine, select_survivors, selectSurvivors_Div);
+    population.set_consumes_fitness(false);
+    population.set_component_times(component_times);
+    population.set_selectParents_Index(select_random_indices<G>(lambda));
+    population.set_mutate_Delta(mutate);
+    population.set_selectSurvivors_Delta(edge_diversity.encode == nullptr ? select_qpdiv_delta(alpha, n, OPT, evaluate_incremental) : select_qpdiv_delta(alpha, n, OPT, evaluate_incremental, edge_diversity));
+    if(lambda > 1) population.set_selectSurvivors_Batch(select_qpdiv_batch(alpha, n, OPT, evaluate_incremental, greedy));
+    if(!checkpoint_file.empty()){
+        load_checkpoint(population, checkpoint_file);
+        termination_criterion = terminate_checkpointing<G>(termination_criterion, checkpoint_file);
+    }
+    population.execute(termination_criterion);
+    return population;
+}
+
+/*
+    Static variants: delta variants composed at compile time on Population_Static, taking policy types for the termination criterion, mutation and evaluation
+*/
+
+template <typename G = T, typename Termination, typename Mutation>
+Population_Static<G, L, Mutation, Select_PDiv_Delta<G>> mu1_unconstrained_static(
+    int seed, 
+    int m, 
+    int n, 
+    int mu,
+    Termination termination_criterion,
+    Mutation mutate
+){
+    Population_Static<G, L, Mutation, Select_PDiv_Delta<G>> population(seed, initialize_random<G>(mu, n, m), mutate, Select_PDiv_Delta<G>{});
+    population.execute(termination_criterion);
+    return population;
+}
+
+template <typename G = T, typename Termination, typename Mutation, typename Evaluate>
+Population_Static<G, L, Mutation, Select_QPDiv_Delta<G, Evaluate>> mu1_constrained_static(
+    int seed, 
+    int m, 
+    int n, 
+    int mu,
+    Termination termination_criterion,
+    Evaluate evaluate,
+    Mutation mutate,
+    double alpha,
+    G initial_gene
+){
+    double OPT = evaluate(initial_gene);
+    Population_Static<G, L, Mutation, Select_QPDiv_Delta<G, Evaluate>> population(seed, initialize_fixed(std::vector<G>(mu, initial_gene)), mutate, Select_QPDiv_Delta<G, Evaluate>{alpha, n, OPT, evaluate});
+    population.execute(termination_criterion);
+    return population;
+}
@@ -13,18 +13,21 @@
 using T = std::vector<std::vector<int>>;
 using L = double;
 
-Population<T,L> simple_test(
+template <typename G = T>
+Population<G,L> simple_test(
     int seed, 
-    std::function<std::vector<T>(std::mt19937&)> initialize,
-    std::function<std::vector<L>(const std::vector<T>&)> evaluate,
-    std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> mutate,
-    std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, std::mt19937&)> select_parents,
-    std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const std::vector<T>&, std::mt19937&)> select_survivors,
-    int generations
+    std::function<std::vector<G>(std::mt19937&)> initialize,
+    std::function<std::vector<L>(const std::vector<G>&)> evaluate,
+    std::function<std::vector<G>(const std::vector<G>&, std::mt19937&)> mutate,
+    std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, std::mt19937&)> select_parents,
+    std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, const std::vector<G>&, std::mt19937&)> select_survivors,
+    int generations,
+    Component_Times* component_times = nullptr
 ){
-    std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> recombine = nullptr;
+    std::function<std::vector<G>(const std::vector<G>&, std::mt19937&)> recombine = nullptr;
 
-    Population population(seed, initialize, evaluate, select_parents, mutate, recombine, select_survivors);
-    population.execute(terminate_generations(generations));
+    Population<G,L> population(seed, initialize, evaluate, select_parents, mutate, recombine, select_survivors);
+    population.set_component_times(component_times);
+    population.execute(terminate_generations<G>(generations));
     return population;
 }
\ No newline at end of file
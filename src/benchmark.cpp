@@ -0,0 +1,253 @@
+#include "utility/testing.hpp"
+#include "utility/benchmarking.hpp"
+
+/*
+    Benchmarks of the operators, solvers and a generation of Population_Mu1 on fixed fixtures (mu, n, m):
+    the problem get_problem(generate_seed(mu, n, m, 0), n, 50) and a population of mu genes from initialize_random
+    Options (all optional):
+        - --grid=mu:n:m,mu:n:m,...: fixtures (default: those of experiments/data/other_experiments/component_times.csv and two larger ones)
+        - --filter=String: only run the benchmarks whose name contains this string
+        - --repetitions=Int, --min-time=Double: repetitions per benchmark and their total time in seconds
+        - --format={"csv", "json"}, --output=String: format of the results and the file to write them to (default: stdout)
+        - --baseline=String: csv results of an earlier run, compares the median times with them and exits with 1 if a benchmark
+          is slower by more than the tolerance
+        - --tolerance=Double: allowed slowdown against the baseline (0.1: 10%)
+        - --perf-counters={"no", "yes"}: "yes" adds the performance counters per call (Linux perf_event_open, -1 where not available)
+*/
+
+struct Benchmark_Options {
+    std::vector<std::tuple<int, int, int>> grid = {{2, 5, 1}, {5, 10, 2}, {10, 30, 1}, {25, 50, 5}, {50, 100, 10}};
+    std::string filter = "";
+    int repetitions = 5;
+    double min_time = 0.5;
+    std::string format = "csv";
+    std::string output = "";
+    std::string baseline = "";
+    double tolerance = 0.1;
+    bool performance_counters = false;
+};
+
+Benchmark_Options parse_benchmark_options(int argc, char **argv){
+    Benchmark_Options options;
+    for(int i = 1; i < argc; i++){
+        std::string argument(argv[i]);
+        size_t separator = argument.find('=');
+        if(argument.rfind("--", 0) != 0 || separator == std::string::npos){
+            throw std::invalid_argument("Invalid option '" + argument + "'. Use --name=value.");
+        }
+        std::string name = argument.substr(2, separator - 2);
+        std::string value = argument.substr(separator + 1);
+        if(name == "grid"){
+            options.grid.clear();
+            std::istringstream fixtures(value);
+            std::string fixture;
+            while(std::getline(fixtures, fixture, ',')){
+                int mu, n, m;
+                char colon1, colon2;
+                std::istringstream fixture_stream(fixture);
+                if(!(fixture_stream >> mu >> colon1 >> n >> colon2 >> m) || colon1 != ':' || colon2 != ':' || !is_viable_combination(mu, n, m)){
+                    throw std::invalid_argument("Invalid fixture '" + fixture + "', pass mu:n:m with m < n.");
+                }
+                options.grid.emplace_back(mu, n, m);
+            }
+        }else if(name == "filter"){
+            options.filter = value;
+        }else if(name == "repetitions"){
+            options.repetitions = std::stoi(value);
+            if(options.repetitions < 1) throw std::invalid_argument("Invalid number of repetitions.");
+        }else if(name == "min-time"){
+            options.min_time = std::stod(value);
+        }else if(name == "format"){
+            if(value != "csv" && value != "json") throw std::invalid_argument("Invalid format.");
+            options.format = value;
+        }else if(name == "output"){
+            options.output = value;
+        }else if(name == "baseline"){
+            options.baseline = value;
+        }else if(name == "tolerance"){
+            options.tolerance = std::stod(value);
+        }else if(name == "perf-counters"){
+            if(value != "no" && value != "yes") throw std::invalid_argument("Invalid perf-counters value.");
+            options.performance_counters = value == "yes";
+        }else{
+            throw std::invalid_argument("Unknown option '" + name + "'.");
+        }
+    }
+    return options;
+}
+
+// Runs the benchmarks of the fixture (mu, n, m) selected by options, appending their results
+void benchmark_fixture(int mu, int n, int m, const Benchmark_Options& options, std::vector<Benchmark_Result>& results){
+
+    int seed = generate_seed(mu, n, m, 0);
+    MachineSchedulingProblem problem = get_problem(seed, n, 50);
+    std::mt19937 generator(seed);
+    std::vector<T> genes = initialize_random(mu, n, m)(generator);
+    auto [evaluate, diversity_measure, diversity_value] = get_eval_div_funcs(problem);
+
+    // offspring of the selections, mutated from the genes ahead of time
+    std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> mutate = mutate_removeinsert(1);
+    std::vector<T> offspring;
+    for(int i = 0; i < 64; i++) offspring.emplace_back(mutate({genes[i % mu]}, generator)[0]);
+
+    long long counter = 0;
+    auto benchmark = [&](std::string name, std::function<double()> operation) {
+        if(name.find(options.filter) == std::string::npos) return;
+        counter = 0;
+        results.emplace_back(run_benchmark(name, mu, n, m, operation, options.repetitions, options.min_time, options.performance_counters));
+        std::cerr << name << " mu=" << mu << " n=" << n << " m=" << m << ": " << results.back().median_ns << " ns" << std::endl;
+    };
+
+    benchmark("evaluate_tardyjobs", [&]() -> double {
+        return evaluate(genes)[0];
+    });
+    benchmark("diversity_DFM", [&]() -> double {
+        counter++;
+        return diversity_measure(genes[counter % mu], genes[(counter + 1) % mu]);
+    });
+    benchmark("diversity_vector", [&]() -> double {
+        return diversity_value(genes);
+    });
+    // the bitset DFM compares encodings made ahead of time, as the delta selections preserve them
+    std::vector<std::pair<std::string, Edge_Encoding>> edge_encodings = {{"dense", Edge_Encoding::dense}, {"sliced", Edge_Encoding::sliced}};
+    for(auto& [name, encoding] : edge_encodings){
+        Edge_Diversity<T> edge_diversity = diversity_DFM_bitset(n, encoding);
+        std::vector<std::vector<uint64_t>> encodings;
+        for(const T& gene : genes) encodings.emplace_back(edge_diversity.encode(gene));
+        benchmark("diversity_DFM_bitset_" + name, [&]() -> double {
+            counter++;
+            return edge_diversity.compare(encodings[counter % mu], encodings[(counter + 1) % mu]);
+        });
+        benchmark("diversity_DFM_bitset_" + name + "_encode", [&]() -> double {
+            return edge_diversity.encode(genes[counter++ % mu]).size();
+        });
+    }
+
+    // the selections run on their own copy of the genes, keeping mu genes while taking one offspring per call
+    std::vector<T> selection_genes;
+    Diversity_Preserver<T> diversity_preserver;
+    std::function<void(std::vector<T>&, const T&, Diversity_Preserver<T>&, std::mt19937&)> pdiv = select_pdiv(diversity_measure);
+    selection_genes = genes;
+    diversity_preserver = initial_diversity_preserver<T>();
+    benchmark("select_pdiv", [&]() -> double {
+        pdiv(selection_genes, offspring[counter++ % offspring.size()], diversity_preserver, generator);
+        return diversity_preserver.squared_sum;
+    });
+    // alpha = 1, so every offspring passes the quality gate and the whole selection is timed
+    double OPT = tardy_jobs(problem, m == 1 ? T{moores_algorithm(problem)} : approximation_algorithm(problem, m));
+    std::function<void(std::vector<T>&, const T&, Diversity_Preserver<T>&, std::mt19937&)> qpdiv = select_qpdiv(1.0, n, OPT, diversity_measure, evaluate);
+    selection_genes = genes;
+    diversity_preserver = initial_diversity_preserver<T>();
+    benchmark("select_qpdiv", [&]() -> double {
+        qpdiv(selection_genes, offspring[counter++ % offspring.size()], diversity_preserver, generator);
+        return diversity_preserver.squared_sum;
+    });
+
+    std::vector<std::tuple<std::string, std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)>, std::function<void(const std::vector<T>&, std::vector<T>&, std::vector<Offspring_Delta>&, std::mt19937&)>>> mutations = {
+        {"mutate_removeinsert", mutate_removeinsert(1), mutate_removeinsert_delta(1)},
+        {"mutate_xremoveinsert", mutate_xremoveinsert(1, 2), mutate_xremoveinsert_delta(1, 2)},
+        {"mutate_neighborswap", mutate_neighborswap(1), mutate_neighborswap_delta(1)}
+    };
+    std::vector<T> mutated;
+    std::vector<Offspring_Delta> deltas;
+    for(auto& [name, mutation, mutation_delta] : mutations){
+        benchmark(name, [&]() -> double {
+            return mutation({genes[counter++ % mu]}, generator)[0][0].size();
+        });
+        benchmark(name + "_delta", [&]() -> double {
+            mutated.assign(1, genes[counter++ % mu]);
+            mutation_delta(mutated, mutated, deltas, generator);
+            return deltas[0].changes.size();
+        });
+    }
+
+    benchmark("moores_algorithm", [&]() -> double {
+        return moores_algorithm(problem)[0];
+    });
+    if(m > 1){
+        benchmark("approximation_algorithm", [&]() -> double {
+            return approximation_algorithm(problem, m)[0].size();
+        });
+    }
+
+    // one generation of Mu1-unconst, on the operators of mu1_unconstrained and of mu1_unconstrained_delta
+    std::function<std::vector<T>(std::mt19937&)> initialize = initialize_fixed(genes);
+    std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> no_function = nullptr;
+    std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, std::mt19937&)> select_parents = select_random(1);
+    std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, std::mt19937&)> no_select_parents = nullptr;
+    std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const std::vector<T>&, std::mt19937&)> select_survivors = nullptr;
+    std::function<void(std::vector<T>&, const T&, Diversity_Preserver<T>&, std::mt19937&)> no_select_survivors_div = nullptr;
+
+    Population_Mu1<T, L> population(seed, initialize, evaluate, select_parents, mutate, no_function, select_survivors, pdiv);
+    population.set_consumes_fitness(false);
+    benchmark("Population_Mu1::execute", [&]() -> double {
+        population.execute();
+        return population.get_generation();
+    });
+
+    Population_Mu1<T, L> population_delta(seed, initialize, evaluate, no_select_parents, no_function, no_function, select_survivors, no_select_survivors_div);
+    population_delta.set_consumes_fitness(false);
+    population_delta.set_selectParents_Index(select_random_indices(1));
+    population_delta.set_mutate_Delta(mutate_removeinsert_delta(1));
+    population_delta.set_selectSurvivors_Delta(select_pdiv_delta());
+    benchmark("Population_Mu1::execute_delta", [&]() -> double {
+        population_delta.execute();
+        return population_delta.get_generation();
+    });
+    for(auto& [name, encoding] : edge_encodings){
+        Population_Mu1<T, L> population_bitset(seed, initialize, evaluate, no_select_parents, no_function, no_function, select_survivors, no_select_survivors_div);
+        population_bitset.set_consumes_fitness(false);
+        population_bitset.set_selectParents_Index(select_random_indices(1));
+        population_bitset.set_mutate_Delta(mutate_removeinsert_delta(1));
+        population_bitset.set_selectSurvivors_Delta(select_pdiv_delta(diversity_DFM_bitset(n, encoding)));
+        benchmark("Population_Mu1::execute_delta_bitset_" + name, [&]() -> double {
+            population_bitset.execute();
+            return population_bitset.get_generation();
+        });
+    }
+    // a (mu+mu) generation on the batch path, mu offspring per call
+    Population_Mu1<T, L> population_batch(seed, initialize, evaluate, no_select_parents, no_function, no_function, select_survivors, no_select_survivors_div);
+    population_batch.set_consumes_fitness(false);
+    population_batch.set_selectParents_Index(select_random_indices(mu));
+    population_batch.set_mutate_Delta(mutate_removeinsert_delta(1));
+    population_batch.set_selectSurvivors_Batch(select_pdiv_batch(false));
+    benchmark("Population_Mu1::execute_batch", [&]() -> double {
+        population_batch.execute();
+        return population_batch.get_generation();
+    });
+    // the same with component times recorded, for their overhead (every 16th generation timed, and every generation timed)
+    Component_Times component_times;
+    population_delta.set_component_times(&component_times);
+    benchmark("Population_Mu1::execute_delta_recorded", [&]() -> double {
+        population_delta.execute();
+        return population_delta.get_generation();
+    });
+    component_times.sampling_interval = 1;
+    benchmark("Population_Mu1::execute_delta_timed", [&]() -> double {
+        population_delta.execute();
+        return population_delta.get_generation();
+    });
+}
+
+int main(int argc, char **argv){
+
+    Benchmark_Options options = parse_benchmark_options(argc, argv);
+
+    std::vector<Benchmark_Result> results;
+    for(auto [mu, n, m] : options.grid) benchmark_fixture(mu, n, m, options, results);
+
+    std::string output = options.format == "json" ? get_benchmark_json(results) : get_benchmark_csv(results);
+    if(options.output.empty()){
+        std::cout << output;
+    }else{
+        std::ofstream file(options.output, std::ios_base::out | std::ios_base::trunc);
+        if(!file.is_open()) throw std::runtime_error("Error opening file: " + options.output);
+        file << output;
+    }
+
+    if(!options.baseline.empty()){
+        bool passed = compare_benchmarks(results, read_benchmark_csv(options.baseline), options.tolerance, std::cerr);
+        return passed ? 0 : 1;
+    }
+    return 0;
+}
@@ -12,19 +12,103 @@
         - m: m_1,m_2,...m_y
         - alpha: a_1,a_2,...,a_z
         - lambda: Double (only for "XRAI", mean of the poisson distribution)
+    Options (optional, after the parameters):
+        - --genes={"nested", "flat"}: gene layout, "flat" keeps every schedule in one contiguous buffer (only for "Mu1-const", "Mu1-unconst", "Simple")
+        - --engine={"dynamic", "static"}: "static" runs "Mu1-const" and "Mu1-unconst" with operators composed at compile time
+        - --allocator={"default", "pool"}: "pool" takes the memory of the genes from a pool per run (only for "Mu1-const", "Mu1-unconst", "Simple")
+        - --resume={"no", "yes"}: "yes" keeps the results in Output-File and only runs the missing ones, checkpointing the populations of long runs
+          in Output-File.checkpoints (pass it from the first start on, only for "Mu1-const", "Mu1-unconst", "Simple")
+        - --shard-index=Int, --shard-count=Int: only run part shard-index of the grid split into shard-count parts of about equal estimated cost
+          (one per task of an array job, merge the outputs with experiments/scripts_hpc/MergeShards.py)
+        - --instances=String: file of the instance cache to take the instances and their OPT from (instances missing in it are computed)
+        - --build-instances=String: only compute the instances and OPT of the grid (mus, ns, ms, runs) and add them to this instance cache file
+        - --component-times={"no", "yes"}: "yes" adds the time (ns) and number of calls of evaluate, selectParents, recombine, mutate, selectSurvivors
+          and termination per run as csv columns (only for "Mu1-const", "Mu1-unconst", "Simple" on the dynamic engine)
+        - --perf-counters={"no", "yes"}: "yes" adds the cycles, instructions, cache misses, branch misses and page faults of every run as csv columns
+          (Linux perf_event_open, -1 where not available, same algorithms as --component-times)
+        - --trajectory={"every:Int", "log:Double", "change"}: record the diversity, best fitness and number of unique genes of every Int-th generation,
+          of log-spaced generations (each about Double times the last) or of the generations changing diversity or best fitness (and of the last generation)
+          into Output-File.trajectory, in blocks of columns (only for "Mu1-const", "Mu1-unconst" on the dynamic engine, convert it to csv with
+          experiments/scripts_analysis/ConvertTrajectory.py)
+        - --offspring=Int: (mu+lambda) variant with this many offspring per generation, which are selected in one batch, generations count the offspring
+          (so the generation budget n*n*mu stays comparable, only for "Mu1-const", "Mu1-unconst" on the dynamic engine)
+        - --offspring-selection={"sequential", "greedy"}: with --offspring, let the offspring join one after another, each followed by the removal of
+          one individual ("sequential"), or remove the individuals one after another from the population joined by all offspring ("greedy")
+        - --diversity={"successor", "bitset-dense", "bitset-sliced"}: compute the DFM scores of the offspring from the successor tables of the population
+          ("successor") or on edge bitset encodings of n*n bits ("bitset-dense") or (1 + log2 n) * n bits ("bitset-sliced") per gene, vectorized with
+          AVX2 / AVX-512 if built with -DEDO_NATIVE=ON (only for "Mu1-const", "Mu1-unconst" on the dynamic engine without --offspring)
+        - --exact-opt=Double: compute OPT for m > 1 with the exact branch and bound, stopping after this many seconds per instance
+          (then the best schedule found is used and the gap to the lower bound on OPT is reported), instead of the approximation algorithm
 */
 
+// Runs the Mu1 algorithms on Population_Static, instantiated for every mutation operator
+template <typename G>
+void run_static_experiment(int argc, char **argv){
+
+    auto [experiment_type, mutation_operator, mutation_operator_delta, output_file, mus, ns, ms, alphas, runs, operator_string] = parse_arguments<G>(argc, argv);
+    Options options = parse_options(argc, argv);
+    Shard shard{options.shard_index, options.shard_count};
+
+    std::string mutation_operator_name(argv[2]);
+    if(mutation_operator_name == "1RAI"){
+        test_algorithm_static<G>(mus, ns, ms, alphas, runs, output_file, experiment_type, operator_string, Mutate_RemoveInsert<G>{1}, options.resume, shard);
+    }else if(mutation_operator_name == "XRAI"){
+        test_algorithm_static<G>(mus, ns, ms, alphas, runs, output_file, experiment_type, operator_string, Mutate_XRemoveInsert<G>{1, std::stod(argv[9])}, options.resume, shard);
+    }else{
+        test_algorithm_static<G>(mus, ns, ms, alphas, runs, output_file, experiment_type, operator_string, Mutate_NeighborSwap<G>{1}, options.resume, shard);
+    }
+}
+
+template <typename G>
+void run_experiment(int argc, char **argv){
+
+    auto [experiment_type, mutation_operator, mutation_operator_delta, output_file, mus, ns, ms, alphas, runs, operator_string] = parse_arguments<G>(argc, argv);
+    Options options = parse_options(argc, argv);
+    Shard shard{options.shard_index, options.shard_count};
+
+    if(experiment_type == "Mu1-const" || experiment_type == "Mu1-unconst" || experiment_type == "Simple"){
+        test_algorithm<G>(mus, ns, ms, alphas, runs, output_file, experiment_type, operator_string, mutation_operator, mutation_operator_delta, options.resume, shard, options.component_times, options.performance_counters, options.trajectory, options.offspring, options.greedy_selection, options.diversity);
+    }else if constexpr (std::is_same_v<G, T>){
+        if(experiment_type == "Base"){
+            test_base(mus, ns, ms, alphas, runs, output_file, mutation_operator, shard);
+        }else if(experiment_type == "Survivor-Opt"){
+            test_mu1_optimization(mus, ns, ms, runs, output_file, mutation_operator, shard);
+        }else{
+            throw std::invalid_argument("Invalid experiment type.");
+        }
+    }else{
+        throw std::invalid_argument("Invalid experiment type for this gene layout or allocator.");
+    }
+}
+
+template <typename G>
+void run(bool static_engine, int argc, char **argv){
+    if(static_engine) run_static_experiment<G>(argc, argv);
+    else run_experiment<G>(argc, argv);
+}
+
 int main(int argc, char **argv){
 
-    auto [experiment_type, mutation_operator, output_file, mus, ns, ms, alphas, runs, operator_string] = parse_arguments(argc, argv);
+    Options options = parse_options(argc, argv);
+    exact_time_limit = options.exact_time_limit;
+
+    if(!options.build_instances.empty()){
+        auto [experiment_type, mutation_operator, mutation_operator_delta, output_file, mus, ns, ms, alphas, runs, operator_string] = parse_arguments(argc, argv);
+        build_instance_cache(mus, ns, ms, runs, options.build_instances);
+        return 0;
+    }
+    if(!options.instances.empty()) Instance_Cache::shared().open(options.instances);
+
+    std::string experiment_type(argv[1]);
+    bool static_engine = options.engine == "static" && (experiment_type == "Mu1-const" || experiment_type == "Mu1-unconst");
+    bool pool = options.allocator == "pool";
 
-    if(experiment_type == "Mu1-const" || experiment_type == "Mu1-unconst" || experiment_type == "Simple"){        test_algorithm(mus, ns, ms, alphas, runs, output_file, experiment_type, operator_string, mutation_operator);
-    }else if(experiment_type == "Base"){
-        test_base(mus, ns, ms, alphas, runs, output_file, mutation_operator);
-    }else if(experiment_type == "Survivor-Opt"){
-        test_mu1_optimization(mus, ns, ms, runs, output_file, mutation_operator);
+    if(options.genes == "flat"){
+        if(pool) run<Pooled_Flat_Schedule>(static_engine, argc, argv);
+        else run<Flat_Schedule>(static_engine, argc, argv);
     }else{
-        throw std::invalid_argument("Invalid experiment type.");
+        if(pool) run<Pooled_Schedule>(static_engine, argc, argv);
+        else run<T>(static_engine, argc, argv);
     }
 
     return 0;
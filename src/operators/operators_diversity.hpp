@@ -5,6 +5,13 @@
 #include <limits>
 #include <vector>
 #include <functional>
+#include <cstdint>
+#include <assert.h>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include "../population/population.hpp"
 
 using T = std::vector<std::vector<int>>;
 using L = double;
@@ -18,35 +25,238 @@ double euclideanNorm(const std::vector<double>& vec) {
     return std::sqrt(sumOfSquares);
 }
 
+// Diversity value of a population of mu genes with n jobs, given the sum of its squared pairwise diversity scores
+double diversity_value(double sum_of_squares, int n, int mu) {
+    return 1 - (std::sqrt(sum_of_squares) / ((n-1) * std::sqrt((mu * mu - mu)/2)));
+}
+
+/*
+    Successor table: Writes the directed follow edges of a gene into successors, where successors[job] is the job following job on the same machine (-1 if job is the last one on its machine)
+    Every job 0, ..., n-1 is expected to occur exactly once in the gene
+*/
+
+template <typename G = T>
+void successor_table(const G& gene, std::vector<int>& successors) {
+    int n = 0;
+    for (const auto& machine : gene) n += machine.size();
+    successors.assign(n, -1);
+    for (const auto& machine : gene) {
+        for (int i = 0; i + 1 < (int) machine.size(); i++) {
+            assert(machine[i] >= 0 && machine[i] < n && "jobs must be numbered 0, ..., n-1");
+            successors[machine[i]] = machine[i+1];
+        }
+    }
+}
+
+// Counts the follow edges of gene which are also contained in the successor table
+template <typename G = T>
+int common_successors(const std::vector<int>& successors, const G& gene) {
+    int common_DFS = 0;
+    for (const auto& machine : gene) {
+        for (int i = 0; i + 1 < (int) machine.size(); i++) {
+            common_DFS += successors[machine[i]] == machine[i+1];
+        }
+    }
+    return common_DFS;
+}
+
+// Edge bitset encoding --------------------------------------------------------------
+
+/*
+    Bitset encodings of the set of directed follow edges of a gene, turning the DFM of two genes into an AND + POPCNT over machine words
+        - dense:        bit a*n+b is set if job b follows job a, n*n bits per gene
+        - sliced:       compact encoding for large n, (1 + ceil(log2 n)) bit-slices of n bits each; slice 0 marks the jobs having a successor,
+                        slice k marks the jobs whose successor has bit k-1 set, so two jobs share their edge if all slices agree on them
+        - automatic:    the smaller one of both for the given n
+    Both encodings are exact.
+*/
+
+enum class Edge_Encoding { automatic, dense, sliced };
+
+/*
+    Diversity measure working on encoded genes: encode is called once per gene, compare on each pair of encodings,
+    change turns the encoding of a parent into the one of its offspring, one edge change of the mutation at a time
+*/
+
+template <typename G = T>
+struct Edge_Diversity {
+    std::function<std::vector<uint64_t>(const G&)> encode;
+    std::function<void(std::vector<uint64_t>&, const Edge_Change&)> change;
+    std::function<double(const std::vector<uint64_t>&, const std::vector<uint64_t>&)> compare;
+};
+
+#if defined(__AVX2__) && !(defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__))
+// Per 64 bit lane popcount using a nibble lookup table (AVX2 has no native vector popcount)
+inline __m256i popcount_epi64(__m256i x) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    __m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(x, low_mask));
+    __m256i high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(x, 4), low_mask));
+    return _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256());
+}
+
+inline int reduce_add_epi64(__m256i x) {
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256((__m256i*) lanes, x);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+#endif
+
+// Number of set bits in the conjunction of the word arrays a and b
+inline int popcount_and(const uint64_t* a, const uint64_t* b, int words) {
+    int count = 0;
+    int i = 0;
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+    __m512i sum = _mm512_setzero_si512();
+    for (; i + 8 <= words; i += 8) {
+        __m512i x = _mm512_and_si512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+        sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(x));
+    }
+    count += _mm512_reduce_add_epi64(sum);
+#elif defined(__AVX2__)
+    __m256i sum = _mm256_setzero_si256();
+    for (; i + 4 <= words; i += 4) {
+        __m256i x = _mm256_and_si256(_mm256_loadu_si256((const __m256i*) (a + i)), _mm256_loadu_si256((const __m256i*) (b + i)));
+        sum = _mm256_add_epi64(sum, popcount_epi64(x));
+    }
+    count += reduce_add_epi64(sum);
+#endif
+    for (; i < words; i++) count += __builtin_popcountll(a[i] & b[i]);
+    return count;
+}
+
+// Number of bit positions set in slice 0 of a and b on which all other slices of a and b agree, slices are stored one after another with words words each
+inline int popcount_sliced(const uint64_t* a, const uint64_t* b, int words, int slices) {
+    int count = 0;
+    int i = 0;
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+    __m512i sum = _mm512_setzero_si512();
+    for (; i + 8 <= words; i += 8) {
+        __m512i equal = _mm512_and_si512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+        for (int k = 1; k < slices; k++) {
+            __m512i differ = _mm512_xor_si512(_mm512_loadu_si512(a + k * words + i), _mm512_loadu_si512(b + k * words + i));
+            equal = _mm512_andnot_si512(differ, equal);
+        }
+        sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(equal));
+    }
+    count += _mm512_reduce_add_epi64(sum);
+#elif defined(__AVX2__)
+    __m256i sum = _mm256_setzero_si256();
+    for (; i + 4 <= words; i += 4) {
+        __m256i equal = _mm256_and_si256(_mm256_loadu_si256((const __m256i*) (a + i)), _mm256_loadu_si256((const __m256i*) (b + i)));
+        for (int k = 1; k < slices; k++) {
+            __m256i differ = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*) (a + k * words + i)), _mm256_loadu_si256((const __m256i*) (b + k * words + i)));
+            equal = _mm256_andnot_si256(differ, equal);
+        }
+        sum = _mm256_add_epi64(sum, popcount_epi64(equal));
+    }
+    count += reduce_add_epi64(sum);
+#endif
+    for (; i < words; i++) {
+        uint64_t equal = a[i] & b[i];
+        for (int k = 1; k < slices; k++) equal &= ~(a[k * words + i] ^ b[k * words + i]);
+        count += __builtin_popcountll(equal);
+    }
+    return count;
+}
+
 // Diversity measure operators (gene level) ------------------------------------------
 
-std::function<double(const T& , const T&)> diversity_DFM(){
-    return [](const T& gene1, const T& gene2) -> double {
-        int common_DFS = 0;
-        for (const auto& machine1 : gene1) {
-            int machine1_size = machine1.size();
-            if (machine1_size < 2) continue;
-            for (const auto& machine2 : gene2) {
-                int machine2_size = machine2.size();
-                if (machine2_size < 2) continue;
-                for(int i = 0; i < machine1_size - 1; i++){
-                    for(int j = 0; j < machine2_size - 1; j++){
-                        if(machine1[i] == machine2[j] && machine1[i+1] == machine2[j+1]){
-                            common_DFS++;
-                        }
-                    }
+/*
+    DFM: Number of directed follow edges (job b directly after job a on the same machine) two genes have in common
+    As every job occurs once per gene, each job has at most one successor, so the count is computed in O(n) via a successor table of gene1
+*/
+
+template <typename G = T>
+std::function<double(const G& , const G&)> diversity_DFM(){
+    return [](const G& gene1, const G& gene2) -> double {
+        thread_local std::vector<int> successors;
+        successor_table(gene1, successors);
+        return common_successors(successors, gene2);
+    };
+}
+
+/*
+    DFM (bitset): DFM on edge bitset encodings, giving the same values as diversity_DFM
+    Arguments:
+        - n:            number of jobs
+        - encoding:     bitset layout, see Edge_Encoding
+*/
+
+template <typename G = T>
+Edge_Diversity<G> diversity_DFM_bitset(int n, Edge_Encoding encoding = Edge_Encoding::automatic){
+    int bits = 1;
+    while ((1 << bits) < n) bits++;
+    int slices = 1 + bits;
+    int slice_words = (n + 63) / 64;
+    size_t dense_words = ((size_t) n * n + 63) / 64;
+    if (encoding == Edge_Encoding::automatic) {
+        encoding = dense_words <= (size_t) slices * slice_words ? Edge_Encoding::dense : Edge_Encoding::sliced;
+    }
+    if (encoding == Edge_Encoding::dense) {
+        auto encode = [n, dense_words](const G& gene) -> std::vector<uint64_t> {
+            std::vector<uint64_t> words(dense_words, 0);
+            for (const auto& machine : gene) {
+                for (int i = 0; i + 1 < (int) machine.size(); i++) {
+                    size_t bit = (size_t) machine[i] * n + machine[i+1];
+                    words[bit / 64] |= uint64_t(1) << (bit % 64);
+                }
+            }
+            return words;
+        };
+        auto change = [n](std::vector<uint64_t>& words, const Edge_Change& edge_change) -> void {
+            if (edge_change.old_successor != -1) {
+                size_t bit = (size_t) edge_change.job * n + edge_change.old_successor;
+                words[bit / 64] &= ~(uint64_t(1) << (bit % 64));
+            }
+            if (edge_change.new_successor != -1) {
+                size_t bit = (size_t) edge_change.job * n + edge_change.new_successor;
+                words[bit / 64] |= uint64_t(1) << (bit % 64);
+            }
+        };
+        auto compare = [](const std::vector<uint64_t>& encoding1, const std::vector<uint64_t>& encoding2) -> double {
+            assert(encoding1.size() == encoding2.size());
+            return popcount_and(encoding1.data(), encoding2.data(), encoding1.size());
+        };
+        return { encode, change, compare };
+    }
+    auto encode = [n, slices, slice_words](const G& gene) -> std::vector<uint64_t> {
+        std::vector<uint64_t> words((size_t) slices * slice_words, 0);
+        for (const auto& machine : gene) {
+            for (int i = 0; i + 1 < (int) machine.size(); i++) {
+                int job = machine[i], successor = machine[i+1];
+                assert(job >= 0 && job < n && "jobs must be numbered 0, ..., n-1");
+                uint64_t mask = uint64_t(1) << (job % 64);
+                words[job / 64] |= mask;
+                for (int k = 1; k < slices; k++) {
+                    if ((successor >> (k - 1)) & 1) words[(size_t) k * slice_words + job / 64] |= mask;
                 }
             }
         }
-        return common_DFS;
+        return words;
+    };
+    auto change = [slices, slice_words](std::vector<uint64_t>& words, const Edge_Change& edge_change) -> void {
+        int job = edge_change.job, successor = edge_change.new_successor;
+        uint64_t mask = uint64_t(1) << (job % 64);
+        for (int k = 0; k < slices; k++) {
+            bool set = successor != -1 && (k == 0 || ((successor >> (k - 1)) & 1));
+            uint64_t& word = words[(size_t) k * slice_words + job / 64];
+            word = set ? word | mask : word & ~mask;
+        }
+    };
+    auto compare = [slices, slice_words](const std::vector<uint64_t>& encoding1, const std::vector<uint64_t>& encoding2) -> double {
+        assert(encoding1.size() == encoding2.size());
+        return popcount_sliced(encoding1.data(), encoding2.data(), slice_words, slices);
     };
+    return { encode, change, compare };
 }
 
 // Diversity measure operators (population level) --------------------------------------
 
-std::function<double(const std::vector<T>&)> diversity_vector(std::function<double(const T& , const T&)> diversity_measure){
-    return [diversity_measure](const std::vector<T>& genes) -> double {
-        int n = std::accumulate(genes[0].begin(), genes[0].end(), 0, [](int sum, const std::vector<int>& machine) -> int {
+template <typename G = T>
+std::function<double(const std::vector<G>&)> diversity_vector(std::function<double(const G& , const G&)> diversity_measure){
+    return [diversity_measure](const std::vector<G>& genes) -> double {
+        int n = std::accumulate(genes[0].begin(), genes[0].end(), 0, [](int sum, const auto& machine) -> int {
             return sum + machine.size();
         });
         int m = genes[0].size();
@@ -65,4 +275,25 @@ std::function<double(const std::vector<double>&)> diversity_vector(int n, int m,
     return [n, m, mu](const std::vector<double>& diversity_scores) -> double {
         return 1 - (euclideanNorm(diversity_scores) / ((n-1) * std::sqrt((mu * mu - mu)/2)));
     };
+}
+
+template <typename G = T>
+std::function<double(const std::vector<G>&)> diversity_vector(Edge_Diversity<G> edge_diversity){
+    return [edge_diversity](const std::vector<G>& genes) -> double {
+        int n = std::accumulate(genes[0].begin(), genes[0].end(), 0, [](int sum, const auto& machine) -> int {
+            return sum + machine.size();
+        });
+        int m = genes[0].size();
+        int mu = genes.size();
+        std::vector<std::vector<uint64_t>> encodings;
+        encodings.reserve(genes.size());
+        for (const auto& gene : genes) encodings.emplace_back(edge_diversity.encode(gene));
+        std::vector<double> diversity_scores;
+        for(int i = 0; i < genes.size(); i++){
+            for(int j = i + 1; j < genes.size(); j++){
+                diversity_scores.emplace_back(edge_diversity.compare(encodings[i], encodings[j]));
+            }
+        }
+        return diversity_vector(n, m, mu)(diversity_scores);
+    };
 }
\ No newline at end of file
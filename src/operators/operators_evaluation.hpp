@@ -2,12 +2,126 @@
 
 #include <functional>
 #include <vector>
+#include <numeric>
 
 #include "../utility/generating.hpp"
+#include "../population/population.hpp"
 
 using T = std::vector<std::vector<int>>;
 using L = double;
 
+// Utility --------------------------------------------------------------------------
+
+// Number of jobs of gene finishing after their due date
+template <typename G = T>
+int tardy_jobs(const MachineSchedulingProblem& problem, const G& gene) {
+    int tardy_jobs_n = 0;
+    for(const auto& schedule : gene){
+        int current_time = 0;
+        for(auto it = schedule.begin(); it != schedule.end(); it++){
+            current_time += problem.processing_times[*it];
+            if(current_time > problem.due_dates[*it]){
+                tardy_jobs_n++;
+            }
+        }
+    }
+    return tardy_jobs_n;
+}
+
+/*
+    Recomputes the completion times and tardiness of the positions first to last (-1: to the end) of machine in the cached schedule of gene,
+    the positions before first are taken from the cache, so only they have to be up to date
+*/
+template <typename G = T>
+void schedule_machine(const MachineSchedulingProblem& problem, const G& gene, int machine, int first, int last, Schedule_Cache& cache) {
+    auto&& schedule = gene[machine];
+    std::vector<int>& completion_times = cache.completion_times[machine];
+    std::vector<uint8_t>& tardy = cache.tardy[machine];
+    int end = (last == -1) ? tardy.size() : last + 1;
+    for(int position = first; position < end; position++) cache.tardy_jobs[machine] -= tardy[position];
+    if(last == -1){
+        end = schedule.size();
+        completion_times.resize(end);
+        tardy.resize(end);
+    }
+    int current_time = first > 0 ? completion_times[first - 1] : 0;
+    for(int position = first; position < end; position++){
+        int job = schedule[position];
+        current_time += problem.processing_times[job];
+        completion_times[position] = current_time;
+        tardy[position] = current_time > problem.due_dates[job];
+        cache.tardy_jobs[machine] += tardy[position];
+    }
+}
+
+// Computes the cached schedule of gene from scratch
+template <typename G = T>
+void schedule_gene(const MachineSchedulingProblem& problem, const G& gene, Schedule_Cache& cache) {
+    cache.completion_times.assign(gene.size(), {});
+    cache.tardy.assign(gene.size(), {});
+    cache.tardy_jobs.assign(gene.size(), 0);
+    for(int machine = 0; machine < gene.size(); machine++){
+        schedule_machine(problem, gene, machine, 0, -1, cache);
+    }
+}
+
+// Updates the cached schedule of the parent of gene to gene, recomputing only the changed machine positions
+template <typename G = T>
+void update_schedule(const MachineSchedulingProblem& problem, const G& gene, Schedule_Cache& cache, const std::vector<Machine_Change>& machines) {
+    for(const auto& change : machines){
+        schedule_machine(problem, gene, change.machine, change.first, change.last, cache);
+    }
+}
+
+// Number of tardy jobs of gene, given the cached schedule of its parent and the changed machine positions, without touching the cache
+template <typename G = T>
+int tardy_jobs_delta(const MachineSchedulingProblem& problem, const G& gene, const Schedule_Cache& parent, const std::vector<Machine_Change>& machines) {
+    int tardy_jobs_n = std::accumulate(parent.tardy_jobs.begin(), parent.tardy_jobs.end(), 0);
+    for(const auto& change : machines){
+        auto&& schedule = gene[change.machine];
+        const std::vector<uint8_t>& tardy = parent.tardy[change.machine];
+        int parent_end = (change.last == -1) ? tardy.size() : change.last + 1;
+        int end = (change.last == -1) ? schedule.size() : change.last + 1;
+        for(int position = change.first; position < parent_end; position++) tardy_jobs_n -= tardy[position];
+        int current_time = change.first > 0 ? parent.completion_times[change.machine][change.first - 1] : 0;
+        for(int position = change.first; position < end; position++){
+            int job = schedule[position];
+            current_time += problem.processing_times[job];
+            if(current_time > problem.due_dates[job]) tardy_jobs_n++;
+        }
+    }
+    return tardy_jobs_n;
+}
+
+// Makespan of gene, given the cached schedule of its parent and the changed machine positions, without touching the cache
+template <typename G = T>
+int makespan_delta(const MachineSchedulingProblem& problem, const G& gene, const Schedule_Cache& parent, const std::vector<Machine_Change>& machines) {
+    int makespan = 0;
+    for(int machine = 0; machine < gene.size(); machine++){
+        const std::vector<int>& completion_times = parent.completion_times[machine];
+        int end_point = completion_times.empty() ? 0 : completion_times.back();
+        for(const auto& change : machines){
+            if(change.machine != machine || change.last != -1) continue;
+            end_point = change.first > 0 ? completion_times[change.first - 1] : 0;
+            auto&& schedule = gene[machine];
+            for(int position = change.first; position < schedule.size(); position++){
+                end_point += problem.processing_times[schedule[position]];
+            }
+        }
+        makespan = std::max(makespan, end_point);
+    }
+    return makespan;
+}
+
+// Makespan of a cached schedule
+int makespan(const Schedule_Cache& cache) {
+    int makespan = 0;
+    for(const auto& completion_times : cache.completion_times){
+        if(!completion_times.empty()) makespan = std::max(makespan, completion_times.back());
+    }
+    return makespan;
+}
+
 // Evaluation Operators -------------------------------------------------------------
 
 /*
@@ -16,12 +130,13 @@ using L = double;
         - problem:          MachineSchedulingProblem struct containing the problem data
 */
 
-std::function<std::vector<L>(const std::vector<T>&)> evaluate_makespan(MachineSchedulingProblem problem) { 
-    return [problem](const std::vector<T>& genes) -> std::vector<L> {
+template <typename G = T>
+std::function<std::vector<L>(const std::vector<G>&)> evaluate_makespan(MachineSchedulingProblem problem) { 
+    return [problem](const std::vector<G>& genes) -> std::vector<L> {
         std::vector<L> fitnesses(genes.size());
-        std::transform(genes.begin(), genes.end(), fitnesses.begin(), [&](const T& gene) -> double {
+        std::transform(genes.begin(), genes.end(), fitnesses.begin(), [&](const G& gene) -> double {
             std::vector<int> end_points;
-            for(auto schedule : gene){
+            for(const auto& schedule : gene){
                 int current_time = 0;
                 for(auto it = schedule.begin(); it != schedule.end(); it++){
                     current_time += problem.processing_times[*it];
@@ -41,23 +156,98 @@ std::function<std::vector<L>(const std::vector<T>&)> evaluate_makespan(MachineSc
         - due_dates:        Points in time where every job is due
 */
 
-std::function<std::vector<L>(const std::vector<T>&)> evaluate_tardyjobs(MachineSchedulingProblem problem) { 
-    int n = problem.processing_times.size();
-    return [problem, n](const std::vector<T>& genes) -> std::vector<L> {
+template <typename G = T>
+std::function<std::vector<L>(const std::vector<G>&)> evaluate_tardyjobs(MachineSchedulingProblem problem) { 
+    return [problem](const std::vector<G>& genes) -> std::vector<L> {
         std::vector<L> fitnesses(genes.size());
-        std::transform(genes.begin(), genes.end(), fitnesses.begin(), [&](const T& gene) -> double {
-            int tardy_jobs_n = 0;
-            for(auto schedule : gene){
-                int current_time = 0;
-                for(auto it = schedule.begin(); it != schedule.end(); it++){
-                    current_time += problem.processing_times[*it];
-                    if(current_time > problem.due_dates[*it]){
-                        tardy_jobs_n++;
-                    }
-                }
-            }
-            return (double) tardy_jobs_n;
+        std::transform(genes.begin(), genes.end(), fitnesses.begin(), [&](const G& gene) -> double {
+            return (double) tardy_jobs(problem, gene);
         });
         return fitnesses;
     };
-}
\ No newline at end of file
+}
+
+// Incremental Evaluation Operators -------------------------------------------------
+
+/*
+    Fitness function keeping the schedule of every gene, so the fitness of a mutated gene is computed from the schedule of its parent on the changed machine positions only
+        - evaluate:         fitness of a gene, computing its schedule into the given cache
+        - evaluate_delta:   fitness of a mutated gene, given the cached schedule of its parent and the changed machine positions
+        - update:           updates the cached schedule of the parent to the mutated gene
+*/
+template <typename G = T>
+struct Incremental_Evaluation {
+    std::function<L(const G&, Schedule_Cache&)> evaluate;
+    std::function<L(const G&, const Schedule_Cache&, const std::vector<Machine_Change>&)> evaluate_delta;
+    std::function<void(const G&, Schedule_Cache&, const std::vector<Machine_Change>&)> update;
+};
+
+/*
+    Makespan Evaluation (incremental): Incremental version of Makespan Evaluation
+    Arguments:
+        - problem:          MachineSchedulingProblem struct containing the problem data
+*/
+
+template <typename G = T>
+Incremental_Evaluation<G> evaluate_makespan_incremental(MachineSchedulingProblem problem) {
+    return {
+        [problem](const G& gene, Schedule_Cache& cache) -> L {
+            schedule_gene(problem, gene, cache);
+            return (double) makespan(cache);
+        },
+        [problem](const G& gene, const Schedule_Cache& parent, const std::vector<Machine_Change>& machines) -> L {
+            return (double) makespan_delta(problem, gene, parent, machines);
+        },
+        [problem](const G& gene, Schedule_Cache& cache, const std::vector<Machine_Change>& machines) -> void {
+            update_schedule(problem, gene, cache, machines);
+        }
+    };
+}
+
+/*
+    Tardyjobs Evaluation (incremental): Incremental version of Tardyjobs Evaluation
+    Arguments:
+        - problem:          MachineSchedulingProblem struct containing the problem data
+*/
+
+template <typename G = T>
+Incremental_Evaluation<G> evaluate_tardyjobs_incremental(MachineSchedulingProblem problem) {
+    return {
+        [problem](const G& gene, Schedule_Cache& cache) -> L {
+            schedule_gene(problem, gene, cache);
+            return (double) std::accumulate(cache.tardy_jobs.begin(), cache.tardy_jobs.end(), 0);
+        },
+        [problem](const G& gene, const Schedule_Cache& parent, const std::vector<Machine_Change>& machines) -> L {
+            return (double) tardy_jobs_delta(problem, gene, parent, machines);
+        },
+        [problem](const G& gene, Schedule_Cache& cache, const std::vector<Machine_Change>& machines) -> void {
+            update_schedule(problem, gene, cache, machines);
+        }
+    };
+}
+
+// Evaluation Policies --------------------------------------------------------------
+
+/*
+    Tardyjobs Evaluation policy: evaluates a single gene like Tardyjobs Evaluation, or incrementally like Tardyjobs Evaluation (incremental), for the statically composed Population_Static
+    Arguments:
+        - problem:          MachineSchedulingProblem struct containing the problem data
+*/
+
+template <typename G = T>
+struct Evaluate_TardyJobs {
+    MachineSchedulingProblem problem;
+    L operator()(const G& gene) const {
+        return (double) tardy_jobs(problem, gene);
+    }
+    L evaluate(const G& gene, Schedule_Cache& cache) const {
+        schedule_gene(problem, gene, cache);
+        return (double) std::accumulate(cache.tardy_jobs.begin(), cache.tardy_jobs.end(), 0);
+    }
+    L evaluate_delta(const G& gene, const Schedule_Cache& parent, const std::vector<Machine_Change>& machines) const {
+        return (double) tardy_jobs_delta(problem, gene, parent, machines);
+    }
+    void update(const G& gene, Schedule_Cache& cache, const std::vector<Machine_Change>& machines) const {
+        update_schedule(problem, gene, cache, machines);
+    }
+};
\ No newline at end of file
@@ -4,6 +4,9 @@
 #include <vector>
 #include <random>
 #include <algorithm>
+#include <type_traits>
+
+#include "../population/gene_pool.hpp"
 
 using T = std::vector<std::vector<int>>;
 using L = double;
@@ -18,8 +21,9 @@ using L = double;
         - machines_n:       Number of machines
 */
 
-std::function<std::vector<T>(std::mt19937&)> initialize_random(int population_size, int jobs_n, int machines_n) {
-    return [population_size, jobs_n, machines_n](std::mt19937& generator) -> std::vector<T> {
+template <typename G = T>
+std::function<std::vector<G>(std::mt19937&)> initialize_random(int population_size, int jobs_n, int machines_n) {
+    return [population_size, jobs_n, machines_n](std::mt19937& generator) -> std::vector<G> {
         std::vector<T> genes(population_size);
         std::uniform_int_distribution< int > distribute_machines(0, machines_n-1);
         std::transform(genes.begin(), genes.end(), genes.begin(), [population_size, jobs_n, machines_n, &generator, distribute_machines](T& gene) mutable -> T {
@@ -32,7 +36,13 @@ std::function<std::vector<T>(std::mt19937&)> initialize_random(int population_si
             }
             return gene;
         });
-        return genes;
+        if constexpr (std::is_same_v<G, T>){
+            return genes;
+        }else{
+            std::vector<G> converted_genes;
+            for(const T& gene : genes) converted_genes.emplace_back(make_gene<G>(gene));
+            return converted_genes;
+        }
     };
 }
 
@@ -42,8 +52,9 @@ std::function<std::vector<T>(std::mt19937&)> initialize_random(int population_si
         - genes:            Vector of genes
 */
 
-std::function<std::vector<T>(std::mt19937&)> initialize_fixed(std::vector<T> genes){
-    return [genes](std::mt19937& generator) -> std::vector<T> {
+template <typename G = T>
+std::function<std::vector<G>(std::mt19937&)> initialize_fixed(std::vector<G> genes){
+    return [genes](std::mt19937& generator) -> std::vector<G> {
         return genes;
     };
 }
\ No newline at end of file
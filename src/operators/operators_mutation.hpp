@@ -5,48 +5,186 @@
 #include <random>
 #include <iostream>
 
+#include "../population/population.hpp"
+#include "../population/flat_schedule.hpp"
+
 using T = std::vector<std::vector<int>>;
 using L = double;
 
 // Utility Functions ----------------------------------------------------------------
 
-T remove_and_insert(const T& gene, std::mt19937& generator){
-    T mutated_gene(gene);
+// Records that the successor of job changes from old_successor to new_successor, merging it with an earlier change of the same job
+void record_change(std::vector<Edge_Change>& changes, int job, int old_successor, int new_successor){
+    for(auto it = changes.begin(); it != changes.end(); it++){
+        if(it->job == job){
+            it->new_successor = new_successor;
+            if(it->old_successor == it->new_successor) changes.erase(it);
+            return;
+        }
+    }
+    if(old_successor != new_successor) changes.push_back({job, old_successor, new_successor});
+}
+
+// Records that the positions first to last (-1: to the end) of machine change, merging it with an earlier change of the same machine
+void record_machine_change(std::vector<Machine_Change>& machines, int machine, int first, int last){
+    for(auto& change : machines){
+        if(change.machine == machine){
+            change.first = std::min(change.first, first);
+            change.last = (change.last == -1 || last == -1) ? -1 : std::max(change.last, last);
+            return;
+        }
+    }
+    machines.push_back({machine, first, last});
+}
+
+// Removes the job at position job_remove of machine_remove and inserts it at position job_insert (counted after the removal) of machine_insert
+template <typename Machine, typename Allocator>
+void move_job(std::vector<Machine, Allocator>& gene, int machine_remove, int job_remove, int machine_insert, int job_insert){
+    int job = gene[machine_remove][job_remove];
+    gene[machine_remove].erase(gene[machine_remove].begin() + job_remove);
+    gene[machine_insert].insert(gene[machine_insert].begin() + job_insert, job);
+}
+
+template <typename Allocator>
+void move_job(Basic_Flat_Schedule<Allocator>& gene, int machine_remove, int job_remove, int machine_insert, int job_insert){
+    gene.move_job(machine_remove, job_remove, machine_insert, job_insert);
+}
+
+// Removes a random job and inserts it at a random position in place, recording the changed edges and machine positions
+template <typename G = T>
+void remove_and_insert(G& gene, Offspring_Delta& delta, std::mt19937& generator){
+    std::vector<Edge_Change>& changes = delta.changes;
     std::uniform_int_distribution< int > distribute_machine(0, gene.size() - 1 );
     int machine_remove;
     do{
         machine_remove = distribute_machine(generator);
-    }while(mutated_gene[machine_remove].size() < 1);
-    std::uniform_int_distribution< int > distribute_job_remove(0, mutated_gene[machine_remove].size() - 1);
+    }while(gene[machine_remove].size() < 1);
+    auto&& schedule_remove = gene[machine_remove];
+    std::uniform_int_distribution< int > distribute_job_remove(0, schedule_remove.size() - 1);
     int job_remove = distribute_job_remove(generator);
-    int job = mutated_gene[machine_remove][job_remove];
-    mutated_gene[machine_remove].erase(mutated_gene[machine_remove].begin() + job_remove);
+    int job = schedule_remove[job_remove];
+    int successor = job_remove + 1 < schedule_remove.size() ? schedule_remove[job_remove + 1] : -1;
+    if(job_remove > 0) record_change(changes, schedule_remove[job_remove - 1], job, successor);
     int machine_insert = distribute_machine(generator);
-    std::uniform_int_distribution< int > distribute_job_insert(0, mutated_gene[machine_insert].size());
+    // positions on machine_insert as if the job was already removed
+    int insert_size = gene[machine_insert].size() - (machine_insert == machine_remove ? 1 : 0);
+    auto job_at = [&](int position) -> int {
+        if(machine_insert == machine_remove && position >= job_remove) position++;
+        return gene[machine_insert][position];
+    };
+    std::uniform_int_distribution< int > distribute_job_insert(0, insert_size);
     int job_insert = distribute_job_insert(generator);
-    mutated_gene[machine_insert].insert(mutated_gene[machine_insert].begin() + job_insert, job);
-    return mutated_gene;
+    int new_successor = job_insert < insert_size ? job_at(job_insert) : -1;
+    if(job_insert > 0) record_change(changes, job_at(job_insert - 1), new_successor, job);
+    record_change(changes, job, successor, new_successor);
+    if(machine_insert == machine_remove){
+        record_machine_change(delta.machines, machine_insert, std::min(job_remove, job_insert), std::max(job_remove, job_insert));
+    }else{
+        record_machine_change(delta.machines, machine_remove, job_remove, -1);
+        record_machine_change(delta.machines, machine_insert, job_insert, -1);
+    }
+    move_job(gene, machine_remove, job_remove, machine_insert, job_insert);
+}
+
+// Swaps the job at position job of machine with its successor in place, recording the changed edges and machine positions
+template <typename G = T>
+void neighbor_swap(G& gene, int machine, int job, Offspring_Delta& delta){
+    std::vector<Edge_Change>& changes = delta.changes;
+    record_machine_change(delta.machines, machine, job, job + 1);
+    auto&& schedule = gene[machine];
+    int first = schedule[job], second = schedule[job + 1];
+    int successor = job + 2 < schedule.size() ? schedule[job + 2] : -1;
+    if(job > 0) record_change(changes, schedule[job - 1], first, second);
+    record_change(changes, second, successor, first);
+    record_change(changes, first, second, successor);
+    std::swap(schedule[job], schedule[job + 1]);
+}
+
+/*
+    Mutations of a single gene in place, recording its delta (edge changes and changed machine positions)
+    Arguments: see the corresponding operators below
+*/
+
+template <typename G = T>
+void removeinsert_delta(G& gene, Offspring_Delta& delta, double mutation_rate, std::mt19937& generator) {
+    std::uniform_real_distribution< double > distribute_rate(0, 1);
+    if(distribute_rate(generator) < mutation_rate){
+        remove_and_insert(gene, delta, generator);
+    }
+}
+
+// distribute_actions is shared by the genes mutated in one operator call, as the poisson distribution may keep state between samples
+template <typename G = T>
+void xremoveinsert_delta(G& gene, Offspring_Delta& delta, double mutation_rate, std::poisson_distribution< int >& distribute_actions, std::mt19937& generator) {
+    std::uniform_real_distribution< double > distribute_rate(0, 1);
+    if(distribute_rate(generator) < mutation_rate){
+        int actions = 1 + distribute_actions(generator);
+        for(int j = 0; j < actions; j++){
+            remove_and_insert(gene, delta, generator);
+        }
+    }
+}
+
+template <typename G = T>
+void neighborswap_delta(G& gene, Offspring_Delta& delta, double mutation_rate, std::mt19937& generator) {
+    std::uniform_real_distribution< double > distribute_rate(0, 1);
+    std::uniform_int_distribution< int > distribute_machine(0, gene.size() - 1 );
+    if(distribute_rate(generator) < mutation_rate){
+        int machine;
+        do{
+            machine = distribute_machine(generator);
+        }while(gene[machine].size() < 2);
+        std::uniform_int_distribution< int > distribute_job(0, gene[machine].size() - 2 );
+        neighbor_swap(gene, machine, distribute_job(generator), delta);
+    }
+}
+
+/*
+    Copies genes into offspring, reusing the memory of the genes already in offspring (offspring may also be genes itself), and mutates the copies in place,
+    recording their deltas in deltas (if given)
+*/
+template <typename G, typename Mutate_Gene>
+void mutate_into(const std::vector<G>& genes, std::vector<G>& offspring, std::vector<Offspring_Delta>* deltas, Mutate_Gene mutate_gene) {
+    thread_local Offspring_Delta unused_delta;
+    offspring.resize(genes.size());
+    if(deltas != nullptr) deltas->resize(genes.size());
+    for(int i = 0; i < genes.size(); i++){
+        offspring[i] = genes[i];
+        Offspring_Delta& delta = (deltas == nullptr) ? unused_delta : (*deltas)[i];
+        delta.changes.clear();
+        delta.machines.clear();
+        mutate_gene(offspring[i], delta);
+    }
 }
 
 // Mutation Operators ---------------------------------------------------------------
 
+/*
+    Every operator comes in two forms: X_into writes the offspring into a caller owned vector, so that its memory is reused over the generations,
+    X returns them as a new vector
+*/
+
 /*
     Remove Insert Mutation: Remove a job from a schedule and insert it again
     Arguments:
         - mutation_rate:        probability of a mutation occurring for each gene
 */
 
-std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> mutate_removeinsert(double mutation_rate) {
-    return [mutation_rate](const std::vector<T>& genes, std::mt19937& generator) -> std::vector<T> {
-        std::vector<T> mutated_genes(genes.size());
-        std::uniform_real_distribution< double > distribute_rate(0, 1);
-        std::transform(genes.begin(), genes.end(), mutated_genes.begin(), [mutation_rate, &generator, distribute_rate](const T& gene) mutable -> T {
-            T mutated_gene;
-            if(distribute_rate(generator) < mutation_rate){
-                mutated_gene = remove_and_insert(gene, generator);
-            }
-            return mutated_gene;
+template <typename G = T>
+std::function<void(const std::vector<G>&, std::vector<G>&, std::mt19937&)> mutate_removeinsert_into(double mutation_rate) {
+    return [mutation_rate](const std::vector<G>& genes, std::vector<G>& offspring, std::mt19937& generator) -> void {
+        mutate_into(genes, offspring, nullptr, [mutation_rate, &generator](G& gene, Offspring_Delta& delta) {
+            removeinsert_delta(gene, delta, mutation_rate, generator);
         });
+    };
+}
+
+template <typename G = T>
+std::function<std::vector<G>(const std::vector<G>&, std::mt19937&)> mutate_removeinsert(double mutation_rate) {
+    std::function<void(const std::vector<G>&, std::vector<G>&, std::mt19937&)> mutate = mutate_removeinsert_into<G>(mutation_rate);
+    return [mutate](const std::vector<G>& genes, std::mt19937& generator) -> std::vector<G> {
+        std::vector<G> mutated_genes;
+        mutate(genes, mutated_genes, generator);
         return mutated_genes;
     };
 }
@@ -58,21 +196,22 @@ std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> mutate_remov
         - lambda:               parameter of the poisson distribution used to sample the number of jobs to be removed and inserted
 */
 
-std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> mutate_xremoveinsert(double mutation_rate, double lambda) {
-    return [mutation_rate, lambda](const std::vector<T>& genes, std::mt19937& generator) -> std::vector<T> {
-        std::vector<T> mutated_genes(genes.size());
-        std::uniform_real_distribution< double > distribute_rate(0, 1);
+template <typename G = T>
+std::function<void(const std::vector<G>&, std::vector<G>&, std::mt19937&)> mutate_xremoveinsert_into(double mutation_rate, double lambda) {
+    return [mutation_rate, lambda](const std::vector<G>& genes, std::vector<G>& offspring, std::mt19937& generator) -> void {
         std::poisson_distribution< int > distribute_actions(lambda);
-        std::transform(genes.begin(), genes.end(), mutated_genes.begin(), [mutation_rate, &generator, distribute_rate, distribute_actions](const T& gene) mutable -> T {
-            T mutated_gene(gene);
-            if(distribute_rate(generator) < mutation_rate){
-                int actions = 1 + distribute_actions(generator);
-                for(int i = 0; i < actions; i++){
-                    mutated_gene = remove_and_insert(mutated_gene, generator);
-                }
-            }
-            return mutated_gene;
+        mutate_into(genes, offspring, nullptr, [mutation_rate, &distribute_actions, &generator](G& gene, Offspring_Delta& delta) {
+            xremoveinsert_delta(gene, delta, mutation_rate, distribute_actions, generator);
         });
+    };
+}
+
+template <typename G = T>
+std::function<std::vector<G>(const std::vector<G>&, std::mt19937&)> mutate_xremoveinsert(double mutation_rate, double lambda) {
+    std::function<void(const std::vector<G>&, std::vector<G>&, std::mt19937&)> mutate = mutate_xremoveinsert_into<G>(mutation_rate, lambda);
+    return [mutate](const std::vector<G>& genes, std::mt19937& generator) -> std::vector<G> {
+        std::vector<G> mutated_genes;
+        mutate(genes, mutated_genes, generator);
         return mutated_genes;
     };
 }
@@ -83,24 +222,91 @@ std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> mutate_xremo
         - mutation_rate:        probability of a mutation occurring for each gene
 */
 
-std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> mutate_neighborswap(double mutation_rate) {
-    return [mutation_rate](const std::vector<T>& genes, std::mt19937& generator) -> std::vector<T> {
-        std::vector<T> mutated_genes(genes.size());
-        std::uniform_real_distribution< double > distribute_rate(0, 1);
-        std::uniform_int_distribution< int > distribute_machine(0, genes[0].size() - 1 );
-        std::transform(genes.begin(), genes.end(), mutated_genes.begin(), [mutation_rate, &generator, distribute_rate, distribute_machine](const T& gene) mutable -> T {
-            T mutated_gene(gene);
-            if(distribute_rate(generator) < mutation_rate){
-                int machine;
-                do{
-                    machine = distribute_machine(generator);
-                }while(gene[machine].size() < 2);
-                std::uniform_int_distribution< int > distribute_job(0, gene[machine].size() - 2 );
-                int job = distribute_job(generator);
-                std::swap(mutated_gene[machine][job], mutated_gene[machine][job + 1]);
-            }
-            return mutated_gene;
+template <typename G = T>
+std::function<void(const std::vector<G>&, std::vector<G>&, std::mt19937&)> mutate_neighborswap_into(double mutation_rate) {
+    return [mutation_rate](const std::vector<G>& genes, std::vector<G>& offspring, std::mt19937& generator) -> void {
+        mutate_into(genes, offspring, nullptr, [mutation_rate, &generator](G& gene, Offspring_Delta& delta) {
+            neighborswap_delta(gene, delta, mutation_rate, generator);
         });
+    };
+}
+
+template <typename G = T>
+std::function<std::vector<G>(const std::vector<G>&, std::mt19937&)> mutate_neighborswap(double mutation_rate) {
+    std::function<void(const std::vector<G>&, std::vector<G>&, std::mt19937&)> mutate = mutate_neighborswap_into<G>(mutation_rate);
+    return [mutate](const std::vector<G>& genes, std::mt19937& generator) -> std::vector<G> {
+        std::vector<G> mutated_genes;
+        mutate(genes, mutated_genes, generator);
         return mutated_genes;
     };
-}
\ No newline at end of file
+}
+
+// Delta Mutation Operators ---------------------------------------------------------
+
+/*
+    The following operators behave like the _into operators above (consuming the same random numbers), but additionally report the delta of every mutated gene
+*/
+
+template <typename G = T>
+std::function<void(const std::vector<G>&, std::vector<G>&, std::vector<Offspring_Delta>&, std::mt19937&)> mutate_removeinsert_delta(double mutation_rate) {
+    return [mutation_rate](const std::vector<G>& genes, std::vector<G>& offspring, std::vector<Offspring_Delta>& deltas, std::mt19937& generator) -> void {
+        mutate_into(genes, offspring, &deltas, [mutation_rate, &generator](G& gene, Offspring_Delta& delta) {
+            removeinsert_delta(gene, delta, mutation_rate, generator);
+        });
+    };
+}
+
+template <typename G = T>
+std::function<void(const std::vector<G>&, std::vector<G>&, std::vector<Offspring_Delta>&, std::mt19937&)> mutate_xremoveinsert_delta(double mutation_rate, double lambda) {
+    return [mutation_rate, lambda](const std::vector<G>& genes, std::vector<G>& offspring, std::vector<Offspring_Delta>& deltas, std::mt19937& generator) -> void {
+        std::poisson_distribution< int > distribute_actions(lambda);
+        mutate_into(genes, offspring, &deltas, [mutation_rate, &distribute_actions, &generator](G& gene, Offspring_Delta& delta) {
+            xremoveinsert_delta(gene, delta, mutation_rate, distribute_actions, generator);
+        });
+    };
+}
+
+template <typename G = T>
+std::function<void(const std::vector<G>&, std::vector<G>&, std::vector<Offspring_Delta>&, std::mt19937&)> mutate_neighborswap_delta(double mutation_rate) {
+    return [mutation_rate](const std::vector<G>& genes, std::vector<G>& offspring, std::vector<Offspring_Delta>& deltas, std::mt19937& generator) -> void {
+        mutate_into(genes, offspring, &deltas, [mutation_rate, &generator](G& gene, Offspring_Delta& delta) {
+            neighborswap_delta(gene, delta, mutation_rate, generator);
+        });
+    };
+}
+
+// Mutation Policies ----------------------------------------------------------------
+
+/*
+    Policy types of the delta operators for the statically composed Population_Static, mutating a gene in place and recording its delta
+    Arguments: see the corresponding operators
+*/
+
+template <typename G = T>
+struct Mutate_RemoveInsert {
+    double mutation_rate;
+    void operator()(G& gene, Offspring_Delta& delta, std::mt19937& generator) const {
+        removeinsert_delta(gene, delta, mutation_rate, generator);
+    }
+};
+
+// the poisson distribution is set up once per policy and reset on every call, which samples the same as a distribution constructed per call
+template <typename G = T>
+struct Mutate_XRemoveInsert {
+    double mutation_rate;
+    double lambda;
+    std::poisson_distribution< int > distribute_actions;
+    Mutate_XRemoveInsert(double mutation_rate, double lambda) : mutation_rate(mutation_rate), lambda(lambda), distribute_actions(lambda) {}
+    void operator()(G& gene, Offspring_Delta& delta, std::mt19937& generator) {
+        distribute_actions.reset();
+        xremoveinsert_delta(gene, delta, mutation_rate, distribute_actions, generator);
+    }
+};
+
+template <typename G = T>
+struct Mutate_NeighborSwap {
+    double mutation_rate;
+    void operator()(G& gene, Offspring_Delta& delta, std::mt19937& generator) const {
+        neighborswap_delta(gene, delta, mutation_rate, generator);
+    }
+};
@@ -16,13 +16,14 @@ using L = double;
         - parent_count: number of individuals to select
 */
 
-std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, std::mt19937&)> select_roulette(int parent_count) {
-    return [parent_count](const std::vector<T>& genes, const std::vector<L>& fitnesses, std::mt19937& generator) -> std::vector<T> {
-        std::vector<T> selected_genes(parent_count);
+template <typename G = T>
+std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, std::mt19937&)> select_roulette(int parent_count) {
+    return [parent_count](const std::vector<G>& genes, const std::vector<L>& fitnesses, std::mt19937& generator) -> std::vector<G> {
+        std::vector<G> selected_genes(parent_count);
         double total_fitness = std::accumulate(fitnesses.begin(), fitnesses.end(), 0.0);
         if(total_fitness == 0){
             std::uniform_int_distribution< int > distribute_point(0, genes.size() - 1 );
-            std::transform(selected_genes.begin(), selected_genes.end(), selected_genes.begin(), [&](T& selected_gene) mutable -> T {
+            std::transform(selected_genes.begin(), selected_genes.end(), selected_genes.begin(), [&](G& selected_gene) mutable -> G {
                 int rand_index = distribute_point(generator);
                 return genes[rand_index];
             });
@@ -34,7 +35,7 @@ std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, std::
         });
         std::partial_sum(probabilities.begin(), probabilities.end(), probabilities.begin());
         std::uniform_real_distribution< double > distribute_value(0, 1);
-        std::transform(selected_genes.begin(), selected_genes.end(), selected_genes.begin(), [&](T& selected_gene) mutable -> T {
+        std::transform(selected_genes.begin(), selected_genes.end(), selected_genes.begin(), [&](G& selected_gene) mutable -> G {
             double rand_value = distribute_value(generator);
             auto it = std::upper_bound(probabilities.begin(), probabilities.end(), rand_value);
             int index = std::distance(probabilities.begin(), it);
@@ -51,13 +52,14 @@ std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, std::
         - parent_count:    number of individuals to select
 */
 
-std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, std::mt19937&)> select_tournament(int tournament_size, int parent_count) {
-    return [tournament_size, parent_count](const std::vector<T>& genes, const std::vector<L>& fitnesses, std::mt19937& generator) -> std::vector<T> {
+template <typename G = T>
+std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, std::mt19937&)> select_tournament(int tournament_size, int parent_count) {
+    return [tournament_size, parent_count](const std::vector<G>& genes, const std::vector<L>& fitnesses, std::mt19937& generator) -> std::vector<G> {
         assert(tournament_size <= genes.size());
         int selected_genes_n = parent_count > genes.size() ? genes.size() : parent_count;
-        std::vector<T> selected_genes(parent_count);
+        std::vector<G> selected_genes(parent_count);
         std::uniform_int_distribution< int > distribute_point(0, genes.size() - 1 );
-        std::transform(selected_genes.begin(), selected_genes.end(), selected_genes.begin(), [&](T& selected_gene) mutable -> T {
+        std::transform(selected_genes.begin(), selected_genes.end(), selected_genes.begin(), [&](G& selected_gene) mutable -> G {
             std::vector<int> tournament_genes(tournament_size);
             for (int i = 0; i < tournament_size; i++) {
                 int rand_index = distribute_point(generator);
@@ -78,11 +80,12 @@ std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, std::
         - parent_size: number of individuals to select
 */
 
-std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, std::mt19937&)> select_random(int parent_count) {
-    return [parent_count](const std::vector<T>& genes, const std::vector<L>& fitnesses, std::mt19937& generator) -> std::vector<T> {
-        std::vector<T> selected_genes(parent_count);
+template <typename G = T>
+std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, std::mt19937&)> select_random(int parent_count) {
+    return [parent_count](const std::vector<G>& genes, const std::vector<L>& fitnesses, std::mt19937& generator) -> std::vector<G> {
+        std::vector<G> selected_genes(parent_count);
         std::uniform_int_distribution< int > distribute_point(0, genes.size() - 1 );
-        std::transform(selected_genes.begin(), selected_genes.end(), selected_genes.begin(), [&](T& selected_gene) mutable -> T {
+        std::transform(selected_genes.begin(), selected_genes.end(), selected_genes.begin(), [&](G& selected_gene) mutable -> G {
             int rand_index = distribute_point(generator);
             return genes[rand_index];
         });
@@ -90,12 +93,30 @@ std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, std::
     };
 }
 
+/*
+    Random Parent Index Selection: Same as Random Parent Selection, but writes the indices of the selected individuals into the given vector
+    Arguments:
+        - parent_size: number of individuals to select
+*/
+
+template <typename G = T>
+std::function<void(const std::vector<G>&, const std::vector<L>&, std::vector<int>&, std::mt19937&)> select_random_indices(int parent_count) {
+    return [parent_count](const std::vector<G>& genes, const std::vector<L>& fitnesses, std::vector<int>& selected_indices, std::mt19937& generator) -> void {
+        selected_indices.resize(parent_count);
+        std::uniform_int_distribution< int > distribute_point(0, genes.size() - 1 );
+        for(auto& index : selected_indices){
+            index = distribute_point(generator);
+        }
+    };
+}
+
 /*
     All Parent Selection: Select all individuals
 */
 
-std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, std::mt19937&)> select_all() {
-    return [](const std::vector<T>& genes, const std::vector<L>& fitnesses, std::mt19937& generator) -> std::vector<T> {
+template <typename G = T>
+std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, std::mt19937&)> select_all() {
+    return [](const std::vector<G>& genes, const std::vector<L>& fitnesses, std::mt19937& generator) -> std::vector<G> {
         return genes;
     };
 }
\ No newline at end of file
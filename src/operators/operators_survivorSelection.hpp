@@ -4,16 +4,116 @@
 #include <vector>
 #include <numeric>
 #include <random>
-#include <map>
 #include <tuple>
+#include <limits>
+#include <algorithm>
 #include <assert.h>
 
 #include "operators_diversity.hpp"
+#include "operators_evaluation.hpp"
 #include "../population/population_mu1.hpp"
 
 using T = std::vector<std::vector<int>>;
 using L = double;
 
+// Utility -------------------------------------------------------------------------
+
+// Number of jobs scheduled in a gene
+template <typename G = T>
+int get_jobs_n(const G& gene) {
+    return std::accumulate(gene.begin(), gene.end(), 0, [](int sum, const auto& machine) -> int {
+        return sum + machine.size();
+    });
+}
+
+/*
+    Returns the index of the individual which yields the highest diversity value when removed, given the pairwise diversity scores of all size individuals
+    Removing an individual subtracts its row of squared scores from the total, so all candidates are rated in O(size) after summing up the rows
+*/
+
+int select_div_index(const std::vector<std::tuple<int, int, double>>& diversity_scores, int size, int n, int mu) {
+    std::vector<double> squared_row_sums(size, 0);
+    double squared_sum = 0;
+    for (const auto& [i, j, score] : diversity_scores) {
+        squared_row_sums[i] += score * score;
+        squared_row_sums[j] += score * score;
+        squared_sum += score * score;
+    }
+    int best_index = 0;
+    double best_value = diversity_value(squared_sum - squared_row_sums[0], n, mu);
+    for (int index = 1; index < size; index++) {
+        double value = diversity_value(squared_sum - squared_row_sums[index], n, mu);
+        if (best_value < value) {
+            best_index = index;
+            best_value = value;
+        }
+    }
+    return best_index;
+}
+
+/*
+    Same as select_div_index for preserved diversity scores, using the preserved sums of squared scores, ties are broken by a random permutation of the individuals
+*/
+
+template <typename G = T>
+int select_pdiv_index(const Diversity_Preserver<G>& diversity_preserver, int n, int mu, std::mt19937& generator) {
+    thread_local std::vector<int> indices;
+    indices.resize(diversity_preserver.squared_row_sums.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::shuffle(indices.begin(), indices.end(), generator);
+    int best_index = indices[0];
+    double best_value = diversity_value(diversity_preserver.squared_sum - diversity_preserver.squared_row_sums[indices[0]], n, mu);
+    for (int index : indices) {
+        double value = diversity_value(diversity_preserver.squared_sum - diversity_preserver.squared_row_sums[index], n, mu);
+        if (best_value < value) {
+            best_index = index;
+            best_value = value;
+        }
+    }
+    return best_index;
+}
+
+/*
+    Sets the diversity score of the slots i and j, keeping the preserved sums of squared scores up to date in O(1)
+    Scores are stored as integers, so the diversity measure has to be integer valued (as DFM is)
+*/
+
+template <typename G = T>
+void set_diversity_score(Diversity_Preserver<G>& diversity_preserver, int i, int j, double score) {
+    int value = (int) score;
+    assert(value == score && "preserved diversity scores must be integers");
+    long long previous_value = diversity_preserver.score(i, j);
+    long long change = (long long) value * value - previous_value * previous_value;
+    diversity_preserver.squared_row_sums[i] += change;
+    diversity_preserver.squared_row_sums[j] += change;
+    diversity_preserver.squared_sum += change;
+    diversity_preserver.score(i, j) = value;
+    diversity_preserver.score(j, i) = value;
+}
+
+// Inserts value into values at position, reusing the memory of spare (the last value removed by erase_reusing)
+template <typename V>
+void insert_reusing(std::vector<V>& values, int position, const V& value, V& spare) {
+    spare = value;
+    values.emplace(values.begin() + position, std::move(spare));
+}
+
+// Removes the value at position from values, keeping its memory in spare
+template <typename V>
+void erase_reusing(std::vector<V>& values, int position, V& spare) {
+    spare = std::move(values[position]);
+    values.erase(values.begin() + position);
+}
+
+// Clears the preserved diversity scores for size slots
+template <typename G = T>
+void reset_diversity_scores(Diversity_Preserver<G>& diversity_preserver, int size) {
+    diversity_preserver.size = size;
+    diversity_preserver.diversity_scores.assign(size * size, 0);
+    diversity_preserver.squared_row_sums.assign(size, 0);
+    diversity_preserver.squared_sum = 0;
+}
+
 // Survivor selection operators ----------------------------------------------------
 
 /*
@@ -23,14 +123,15 @@ using L = double;
         - evaluate: function taking a vector of genes and returning a vector of fitnesses
 */
 
-std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const std::vector<T>&, std::mt19937&)> select_mu(int mu, std::function<std::vector<L>(const std::vector<T>&)> evaluate) {
-    return [mu, evaluate](const std::vector<T>& parents, const std::vector<L>& fitnesses_parents, const std::vector<T>& offspring, std::mt19937& generator) -> std::vector<T> {
-        std::vector<T> combined = parents;
+template <typename G = T>
+std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, const std::vector<G>&, std::mt19937&)> select_mu(int mu, std::function<std::vector<L>(const std::vector<G>&)> evaluate) {
+    return [mu, evaluate](const std::vector<G>& parents, const std::vector<L>& fitnesses_parents, const std::vector<G>& offspring, std::mt19937& generator) -> std::vector<G> {
+        std::vector<G> combined = parents;
         combined.insert(combined.end(), offspring.begin(), offspring.end());
         std::vector<L> fitnesses = fitnesses_parents;
         std::vector<L> fitnesses_children = evaluate(offspring);
         fitnesses.insert(fitnesses.end(), fitnesses_children.begin(), fitnesses_children.end());
-        std::vector<T> selected_genes(mu);
+        std::vector<G> selected_genes(mu);
         std::vector<int> indices(combined.size());
         std::iota(indices.begin(), indices.end(), 0);
         std::partial_sort(indices.begin(), indices.begin() + mu, indices.end(), [&](int a, int b) {
@@ -49,9 +150,10 @@ std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const
         - diversity_measure:    function taking two genes and returning a double representing the diversity
 */
 
-std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const std::vector<T>&, std::mt19937&)> select_div(std::function<double(const T&, const T&)> diversity_measure) {
-    return [diversity_measure](const std::vector<T>& parents, const std::vector<L>& fitnesses_parents, const std::vector<T>& offspring, std::mt19937& generator) -> std::vector<T> {
-        std::vector<T> selected_genes = parents;
+template <typename G = T>
+std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, const std::vector<G>&, std::mt19937&)> select_div(std::function<double(const G&, const G&)> diversity_measure) {
+    return [diversity_measure](const std::vector<G>& parents, const std::vector<L>& fitnesses_parents, const std::vector<G>& offspring, std::mt19937& generator) -> std::vector<G> {
+        std::vector<G> selected_genes = parents;
         selected_genes.insert(selected_genes.end(), offspring.begin(), offspring.end());
         std::vector<std::tuple<int, int, double>> diversity_scores;
         diversity_scores.reserve(selected_genes.size() * (selected_genes.size() - 1) / 2);
@@ -60,33 +162,8 @@ std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const
                 diversity_scores.emplace_back(i, j, diversity_measure(selected_genes[i], selected_genes[j]));
             }
         }
-        std::vector<int> indices(selected_genes.size());
-        std::iota(indices.begin(), indices.end(), 0);
-        int n = std::accumulate(selected_genes[0].begin(), selected_genes[0].end(), 0, [](int sum, const std::vector<int>& machine) -> int {
-            return sum + machine.size();
-        });
-        int m = selected_genes[0].size();
-        int mu = parents.size();
-        std::function<double(const std::vector<double>&)> div_value = diversity_vector(n, m, mu);
-        std::vector<double> diversity_values;
-        diversity_values.reserve(indices.size());
-        for (const auto& index : indices) {
-            std::vector<double> div_vector;
-            div_vector.reserve(indices.size());
-            auto isIndexExcluded = [&index](const auto& score) {
-                return (std::get<0>(score) != index) && (std::get<1>(score) != index);
-            };
-            for (const auto& score : diversity_scores) {
-                if (isIndexExcluded(score)) {
-                    div_vector.push_back(std::get<2>(score));
-                }
-            }
-            diversity_values.emplace_back(div_value(div_vector));
-        }
-        auto max_it = std::max_element(indices.begin(), indices.end(), [&](int a, int b) {
-            return diversity_values[a] < diversity_values[b];
-        });
-        selected_genes.erase(selected_genes.begin() + *max_it);
+        int removed = select_div_index(diversity_scores, selected_genes.size(), get_jobs_n(selected_genes[0]), parents.size());
+        selected_genes.erase(selected_genes.begin() + removed);
         return selected_genes;
     };
 };
@@ -100,11 +177,12 @@ std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const
         - evaluate:             function taking a vector of genes and returning a vector of fitnesses
 */
 
-std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const std::vector<T>&, std::mt19937&)> select_qdiv(double alpha, int n, double OPT, std::function<double(const T&, const T&)> diversity_measure, std::function<std::vector<L>(const std::vector<T>&)> evaluate) {
-    return [alpha, n, OPT, diversity_measure, evaluate](const std::vector<T>& parents, const std::vector<L>& fitnesses_parents, const std::vector<T>& offspring, std::mt19937& generator) -> std::vector<T> {
+template <typename G = T>
+std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, const std::vector<G>&, std::mt19937&)> select_qdiv(double alpha, int n, double OPT, std::function<double(const G&, const G&)> diversity_measure, std::function<std::vector<L>(const std::vector<G>&)> evaluate) {
+    return [alpha, n, OPT, diversity_measure, evaluate](const std::vector<G>& parents, const std::vector<L>& fitnesses_parents, const std::vector<G>& offspring, std::mt19937& generator) -> std::vector<G> {
         assert(offspring.size() == 1);
         if(evaluate(offspring)[0] > alpha * ( n - OPT ) + OPT) return parents;
-        std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const std::vector<T>&, std::mt19937&)> div = select_div(diversity_measure);
+        std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, const std::vector<G>&, std::mt19937&)> div = select_div(diversity_measure);
         return div(parents, {}, offspring, generator);
     };
 };
@@ -115,10 +193,11 @@ std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const
         - quality_bound:    fitness value threshold
         - evaluate:         function taking a vector of genes and returning a vector of fitnesses
 */
-std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const std::vector<T>&, std::mt19937&)> select_quality(double quality_bound, std::function<std::vector<L>(const std::vector<T>&)> evaluate) {
-    return [quality_bound, evaluate](const std::vector<T>& parents, const std::vector<L>& fitnesses_parents, const std::vector<T>& offspring, std::mt19937& generator) -> std::vector<T> {
+template <typename G = T>
+std::function<std::vector<G>(const std::vector<G>&, const std::vector<L>&, const std::vector<G>&, std::mt19937&)> select_quality(double quality_bound, std::function<std::vector<L>(const std::vector<G>&)> evaluate) {
+    return [quality_bound, evaluate](const std::vector<G>& parents, const std::vector<L>& fitnesses_parents, const std::vector<G>& offspring, std::mt19937& generator) -> std::vector<G> {
         int mu = parents.size();
-        std::vector<T> combined = parents;
+        std::vector<G> combined = parents;
         std::vector<L> fitnesses = fitnesses_parents;
         combined.insert(combined.end(), offspring.begin(), offspring.end());
         std::vector<L> fitnesses_offspring = evaluate(offspring);
@@ -131,7 +210,7 @@ std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const
             }
         }
         if(combined.size() <= mu) return combined;
-        std::vector<T> selected_genes(mu);
+        std::vector<G> selected_genes(mu);
         std::vector<int> indices(mu);
         std::iota(indices.begin(), indices.end(), 0);
         std::partial_sort(indices.begin(), indices.begin() + parents.size(), indices.end(), [&](int a, int b) {
@@ -146,64 +225,136 @@ std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const
 
 /*
     pdiv-Selection: Selects the mu (=parent size) individuals with the highest diversity from the combined population of parents and one offspring, preserve diversity scores to improve runtime
+    Genes and diversity preserver are updated in place
     Arguments
         - diversity_measure:    function taking two genes and returning a double representing the diversity
 */
 
-std::function<Diversity_Preserver<T>(const std::vector<T>&, const T&, const Diversity_Preserver<T>&, std::mt19937&)> select_pdiv(std::function<double(const T&, const T&)> diversity_measure) {
-    return [diversity_measure](const std::vector<T>& parents, const T& offspring, const Diversity_Preserver<T>& diversity_preserver, std::mt19937& generator) -> Diversity_Preserver<T> {
-        std::vector<T> selected_genes = parents;
-        selected_genes.emplace(selected_genes.begin() + diversity_preserver.index, offspring);
+template <typename G = T>
+std::function<void(std::vector<G>&, const G&, Diversity_Preserver<G>&, std::mt19937&)> select_pdiv(std::function<double(const G&, const G&)> diversity_measure) {
+    return [diversity_measure](std::vector<G>& genes, const G& offspring, Diversity_Preserver<G>& diversity_preserver, std::mt19937& generator) -> void {
+        int mu = genes.size();
+        int index = diversity_preserver.index;
+        genes.emplace(genes.begin() + index, offspring);
 
-        std::map<std::tuple<int, int>, double> diversity_scores;
         if(diversity_preserver.first){
-            for(int i = 0; i < selected_genes.size(); i++){
-                for(int j = i + 1; j < selected_genes.size(); j++){
-                    diversity_scores[{i,j}] = diversity_measure(selected_genes[i], selected_genes[j]);
+            reset_diversity_scores(diversity_preserver, genes.size());
+            for(int i = 0; i < genes.size(); i++){
+                for(int j = i + 1; j < genes.size(); j++){
+                    set_diversity_score(diversity_preserver, i, j, diversity_measure(genes[i], genes[j]));
                 }
             }
         }else{
-            diversity_scores = diversity_preserver.diversity_scores;
-            for(int i = 0; i < diversity_preserver.index; i++){
-                diversity_scores[{i,diversity_preserver.index}] = diversity_measure(selected_genes[i], selected_genes[diversity_preserver.index]);
+            for(int i = 0; i < index; i++){
+                set_diversity_score(diversity_preserver, i, index, diversity_measure(genes[i], genes[index]));
             }
-            for(int i = diversity_preserver.index + 1; i < selected_genes.size(); i++){
-                diversity_scores[{diversity_preserver.index,i}] = diversity_measure(selected_genes[diversity_preserver.index], selected_genes[i]);
+            for(int i = index + 1; i < genes.size(); i++){
+                set_diversity_score(diversity_preserver, index, i, diversity_measure(genes[index], genes[i]));
             }
         }
         
-        std::vector<int> indices(selected_genes.size());
-        std::iota(indices.begin(), indices.end(), 0);
-        std::shuffle(indices.begin(), indices.end(), generator);
+        int removed = select_pdiv_index(diversity_preserver, get_jobs_n(genes[0]), mu, generator);
+        genes.erase(genes.begin() + removed);
+        diversity_preserver.index = removed;
+        diversity_preserver.first = false;
+    };
+}
 
-        int n = std::accumulate(selected_genes[0].begin(), selected_genes[0].end(), 0, [](int sum, const std::vector<int>& machine) -> int {
-            return sum + machine.size();
-        });
-        int m = selected_genes[0].size();
-        int mu = parents.size();
+/*
+    pdiv-Selection (delta): pdiv-Selection for DFM, where the scores of the offspring are derived from the preserved scores of its parent and the edge changes of the mutation, O(k) per individual for k changed edges
+    Successor tables of all individuals are preserved alongside the diversity scores
+    If edge_diversity is given, edge encodings are preserved instead, the one of the offspring is derived from the one of its parent and its scores are compared on the encodings
+*/
+
+template <typename G = T>
+void pdiv_delta(std::vector<G>& genes, const G& offspring, const Offspring_Delta& delta, Diversity_Preserver<G>& diversity_preserver, std::mt19937& generator, const Edge_Diversity<G>* edge_diversity = nullptr) {
+    int mu = genes.size();
+    int index = diversity_preserver.index;
 
-        std::function<double(const std::vector<double>&)> div_value = diversity_vector(n, m, mu);
-        std::vector<double> diversity_values;
-        diversity_values.reserve(indices.size());
-        for (const auto& index : indices) {
-            std::vector<double> div_vector;
-            div_vector.reserve(indices.size());
-            auto isIndexExcluded = [&index](const auto& entry) {
-                const auto& [firstIndex, secondIndex] = entry.first;
-                return (firstIndex != index) && (secondIndex != index);
-            };
-            for (const auto& entry : diversity_scores) {
-                if (isIndexExcluded(entry)) {
-                    div_vector.push_back(entry.second);
+    std::vector<std::vector<int>>& successors = diversity_preserver.successors;
+    std::vector<std::vector<uint64_t>>& encodings = diversity_preserver.encodings;
+    if(diversity_preserver.first){
+        insert_reusing(genes, index, offspring, diversity_preserver.spare_gene);
+        reset_diversity_scores(diversity_preserver, genes.size());
+        if(edge_diversity != nullptr){
+            encodings.clear();
+            for(const auto& gene : genes) encodings.emplace_back(edge_diversity->encode(gene));
+            for(int i = 0; i < genes.size(); i++){
+                for(int j = i + 1; j < genes.size(); j++){
+                    set_diversity_score(diversity_preserver, i, j, edge_diversity->compare(encodings[i], encodings[j]));
+                }
+            }
+        }else{
+            successors.assign(genes.size(), {});
+            for(int i = 0; i < genes.size(); i++){
+                successor_table(genes[i], successors[i]);
+            }
+            for(int i = 0; i < genes.size(); i++){
+                for(int j = i + 1; j < genes.size(); j++){
+                    set_diversity_score(diversity_preserver, i, j, common_successors(successors[i], genes[j]));
                 }
             }
-            diversity_values[index] = div_value(div_vector);
         }
-        auto max_it = std::max_element(indices.begin(), indices.end(), [&](int a, int b) {
-            return diversity_values[a] < diversity_values[b];
-        });
-        selected_genes.erase(selected_genes.begin() + *max_it);
-        return { *max_it, false, diversity_scores, selected_genes };
+    }else if(edge_diversity != nullptr){
+        std::vector<uint64_t>& offspring_encoding = diversity_preserver.spare_encoding;
+        offspring_encoding = encodings[delta.parent];
+        for(const auto& change : delta.changes){
+            edge_diversity->change(offspring_encoding, change);
+        }
+        insert_reusing(genes, index, offspring, diversity_preserver.spare_gene);
+        encodings.emplace(encodings.begin() + index, std::move(offspring_encoding));
+        for(int i = 0; i < genes.size(); i++){
+            if(i != index) set_diversity_score(diversity_preserver, i, index, edge_diversity->compare(encodings[i], encodings[index]));
+        }
+    }else{
+        int parent_edges = get_jobs_n(genes[delta.parent]);
+        for(const auto& machine : genes[delta.parent]){
+            if(machine.size() > 0) parent_edges--;
+        }
+        std::vector<int>& offspring_successors = diversity_preserver.spare_successors;
+        offspring_successors = successors[delta.parent];
+        for(const auto& change : delta.changes){
+            offspring_successors[change.job] = change.new_successor;
+        }
+        insert_reusing(genes, index, offspring, diversity_preserver.spare_gene);
+        successors.emplace(successors.begin() + index, std::move(offspring_successors));
+        int parent = delta.parent < index ? delta.parent : delta.parent + 1;
+        for(int i = 0; i < genes.size(); i++){
+            if(i == index) continue;
+            int score = (i == parent) ? parent_edges : diversity_preserver.score(i, parent);
+            for(const auto& change : delta.changes){
+                int successor = successors[i][change.job];
+                if(change.old_successor != -1 && successor == change.old_successor) score--;
+                if(change.new_successor != -1 && successor == change.new_successor) score++;
+            }
+            set_diversity_score(diversity_preserver, i, index, score);
+        }
+    }
+
+    int removed = select_pdiv_index(diversity_preserver, get_jobs_n(genes[0]), mu, generator);
+    erase_reusing(genes, removed, diversity_preserver.spare_gene);
+    if(edge_diversity != nullptr) erase_reusing(encodings, removed, diversity_preserver.spare_encoding);
+    else erase_reusing(successors, removed, diversity_preserver.spare_successors);
+    diversity_preserver.index = removed;
+    diversity_preserver.first = false;
+}
+
+template <typename G = T>
+std::function<void(std::vector<G>&, const G&, const Offspring_Delta&, Diversity_Preserver<G>&, std::mt19937&)> select_pdiv_delta() {
+    return [](std::vector<G>& genes, const G& offspring, const Offspring_Delta& delta, Diversity_Preserver<G>& diversity_preserver, std::mt19937& generator) -> void {
+        pdiv_delta(genes, offspring, delta, diversity_preserver, generator);
+    };
+}
+
+/*
+    pdiv-Selection (bitset delta): pdiv-Selection (delta) on preserved edge encodings
+    Arguments
+        - edge_diversity:       diversity measure working on encoded genes, see diversity_DFM_bitset
+*/
+template <typename G = T>
+std::function<void(std::vector<G>&, const G&, const Offspring_Delta&, Diversity_Preserver<G>&, std::mt19937&)> select_pdiv_delta(Edge_Diversity<G> edge_diversity) {
+    return [edge_diversity](std::vector<G>& genes, const G& offspring, const Offspring_Delta& delta, Diversity_Preserver<G>& diversity_preserver, std::mt19937& generator) -> void {
+        pdiv_delta(genes, offspring, delta, diversity_preserver, generator, &edge_diversity);
     };
 }
 
@@ -216,13 +367,319 @@ std::function<Diversity_Preserver<T>(const std::vector<T>&, const T&, const Dive
         - diversity_measure:    function taking two genes and returning a double representing the diversity
         - evaluate:             function taking a vector of genes and returning a vector of fitnesses
 */
-std::function<Diversity_Preserver<T>(const std::vector<T>&, const T&, const Diversity_Preserver<T>&, std::mt19937&)> select_qpdiv(double alpha, int n, double OPT, std::function<double(const T&, const T&)> diversity_measure, std::function<std::vector<L>(const std::vector<T>&)> evaluate) {
-    return [alpha, n, OPT, diversity_measure, evaluate](const std::vector<T>& parents, const T& offspring, const Diversity_Preserver<T>& diversity_preserver, std::mt19937& generator) -> Diversity_Preserver<T> {
-        if(evaluate({offspring})[0] > alpha * ( n - OPT ) + OPT) return diversity_preserver;
-        std::function<Diversity_Preserver<T>(const std::vector<T>&, const T&, const Diversity_Preserver<T>&, std::mt19937&)> div = select_pdiv(diversity_measure);
-        return div(parents, offspring, diversity_preserver, generator);
+template <typename G = T>
+std::function<void(std::vector<G>&, const G&, Diversity_Preserver<G>&, std::mt19937&)> select_qpdiv(double alpha, int n, double OPT, std::function<double(const G&, const G&)> diversity_measure, std::function<std::vector<L>(const std::vector<G>&)> evaluate) {
+    std::function<void(std::vector<G>&, const G&, Diversity_Preserver<G>&, std::mt19937&)> div = select_pdiv(diversity_measure);
+    return [alpha, n, OPT, div, evaluate](std::vector<G>& genes, const G& offspring, Diversity_Preserver<G>& diversity_preserver, std::mt19937& generator) -> void {
+        diversity_preserver.offspring_fitness = evaluate({offspring})[0];
+        diversity_preserver.offspring_evaluated = true;
+        if(diversity_preserver.offspring_fitness > alpha * ( n - OPT ) + OPT) return;
+        div(genes, offspring, diversity_preserver, generator);
+    };
+};
+
+/*
+    qpdiv-Selection (delta): qpdiv-Selection for DFM based on pdiv-Selection (delta)
+    Arguments:
+        - alpha:                parameter for quality threshold
+        - n:                    number of jobs
+        - OPT:                  fitness value of optimal solution
+        - evaluate:             function taking a vector of genes and returning a vector of fitnesses
+*/
+template <typename G = T>
+std::function<void(std::vector<G>&, const G&, const Offspring_Delta&, Diversity_Preserver<G>&, std::mt19937&)> select_qpdiv_delta(double alpha, int n, double OPT, std::function<std::vector<L>(const std::vector<G>&)> evaluate) {
+    std::function<void(std::vector<G>&, const G&, const Offspring_Delta&, Diversity_Preserver<G>&, std::mt19937&)> div = select_pdiv_delta<G>();
+    return [alpha, n, OPT, div, evaluate](std::vector<G>& genes, const G& offspring, const Offspring_Delta& delta, Diversity_Preserver<G>& diversity_preserver, std::mt19937& generator) -> void {
+        diversity_preserver.offspring_fitness = evaluate({offspring})[0];
+        diversity_preserver.offspring_evaluated = true;
+        if(diversity_preserver.offspring_fitness > alpha * ( n - OPT ) + OPT) return;
+        div(genes, offspring, delta, diversity_preserver, generator);
+    };
+};
+
+/*
+    Applies pdiv-Selection (delta) to offspring if its fitness, computed incrementally from the cached schedule of its parent, is at most quality_bound,
+    keeping the cached schedules of the genes up to date (the one of a removed gene is reused for the offspring)
+    The fitness is handed back in diversity_preserver.offspring_fitness, so the population does not evaluate the offspring again
+*/
+template <typename G, typename Evaluation>
+void qpdiv_delta(std::vector<G>& genes, const G& offspring, const Offspring_Delta& delta, Diversity_Preserver<G>& diversity_preserver, std::mt19937& generator, double quality_bound, const Evaluation& evaluation, const Edge_Diversity<G>* edge_diversity = nullptr) {
+    std::vector<Schedule_Cache>& schedules = diversity_preserver.schedules;
+    if(schedules.size() != genes.size()){
+        schedules.assign(genes.size(), {});
+        for(int i = 0; i < genes.size(); i++){
+            evaluation.evaluate(genes[i], schedules[i]);
+        }
+    }
+    diversity_preserver.offspring_fitness = evaluation.evaluate_delta(offspring, schedules[delta.parent], delta.machines);
+    diversity_preserver.offspring_evaluated = true;
+    if(diversity_preserver.offspring_fitness > quality_bound) return;
+
+    int index = diversity_preserver.index;
+    pdiv_delta(genes, offspring, delta, diversity_preserver, generator, edge_diversity);
+    int removed = diversity_preserver.index;
+    if(removed == index) return;
+    // position of the removed gene before and of the offspring after the selection
+    int removed_schedule = removed < index ? removed : removed - 1;
+    int offspring_schedule = removed < index ? index - 1 : index;
+    Schedule_Cache schedule = std::move(schedules[removed_schedule]);
+    if(removed_schedule != delta.parent) schedule = schedules[delta.parent];
+    evaluation.update(offspring, schedule, delta.machines);
+    schedules.erase(schedules.begin() + removed_schedule);
+    schedules.emplace(schedules.begin() + offspring_schedule, std::move(schedule));
+}
+
+/*
+    qpdiv-Selection (incremental delta): qpdiv-Selection (delta), evaluating the offspring incrementally from the schedule of its parent
+    Arguments:
+        - alpha:                parameter for quality threshold
+        - n:                    number of jobs
+        - OPT:                  fitness value of optimal solution
+        - evaluation:           incremental fitness function
+*/
+template <typename G = T>
+std::function<void(std::vector<G>&, const G&, const Offspring_Delta&, Diversity_Preserver<G>&, std::mt19937&)> select_qpdiv_delta(double alpha, int n, double OPT, Incremental_Evaluation<G> evaluation) {
+    return [alpha, n, OPT, evaluation](std::vector<G>& genes, const G& offspring, const Offspring_Delta& delta, Diversity_Preserver<G>& diversity_preserver, std::mt19937& generator) -> void {
+        qpdiv_delta(genes, offspring, delta, diversity_preserver, generator, alpha * ( n - OPT ) + OPT, evaluation);
+    };
+};
+
+/*
+    qpdiv-Selection (incremental bitset delta): qpdiv-Selection (incremental delta) on preserved edge encodings
+    Arguments:
+        - alpha:                parameter for quality threshold
+        - n:                    number of jobs
+        - OPT:                  fitness value of optimal solution
+        - evaluation:           incremental fitness function
+        - edge_diversity:       diversity measure working on encoded genes, see diversity_DFM_bitset
+*/
+template <typename G = T>
+std::function<void(std::vector<G>&, const G&, const Offspring_Delta&, Diversity_Preserver<G>&, std::mt19937&)> select_qpdiv_delta(double alpha, int n, double OPT, Incremental_Evaluation<G> evaluation, Edge_Diversity<G> edge_diversity) {
+    return [alpha, n, OPT, evaluation, edge_diversity](std::vector<G>& genes, const G& offspring, const Offspring_Delta& delta, Diversity_Preserver<G>& diversity_preserver, std::mt19937& generator) -> void {
+        qpdiv_delta(genes, offspring, delta, diversity_preserver, generator, alpha * ( n - OPT ) + OPT, evaluation, &edge_diversity);
     };
 };
+
+/*
+    pdiv-Selection (batch delta): (mu+lambda) variant of pdiv-Selection (delta), taking all offspring of a generation at once
+    All offspring stem from the genes before the generation, so the scores of an offspring are derived from the scores of its parent (against the genes)
+    and from the scores of the other offspring to its parent (against the other offspring), before any individual is removed
+    Without greedy, the offspring join the population one after another, each followed by the removal of one individual (pdiv-Selection applied lambda times),
+    with greedy, all offspring join and then lambda individuals are removed one after another, each the one leaving the highest diversity
+    If evaluation is given, offspring with a fitness above quality_bound (computed incrementally from the cached schedule of their parent) are discarded first
+    The surviving offspring and the individual removed last take the slots of the removed genes and the free slot, O(lambda * (mu + lambda)) per generation
+*/
+template <typename G, typename Evaluation = Incremental_Evaluation<G>>
+void pdiv_delta_batch(std::vector<G>& genes, const std::vector<G>& offspring, const std::vector<Offspring_Delta>& deltas, Diversity_Preserver<G>& diversity_preserver, std::mt19937& generator, bool greedy, double quality_bound = std::numeric_limits<double>::infinity(), const Evaluation* evaluation = nullptr) {
+    int mu = genes.size();
+    int n = get_jobs_n(genes[0]);
+    std::vector<std::vector<int>>& successors = diversity_preserver.successors;
+    std::vector<Schedule_Cache>& schedules = diversity_preserver.schedules;
+    if(evaluation != nullptr && schedules.size() != genes.size()){
+        schedules.assign(genes.size(), {});
+        for(int i = 0; i < mu; i++){
+            evaluation->evaluate(genes[i], schedules[i]);
+        }
+    }
+
+    thread_local std::vector<int> accepted;
+    accepted.clear();
+    for(int k = 0; k < (int) offspring.size(); k++){
+        if(evaluation == nullptr || evaluation->evaluate_delta(offspring[k], schedules[deltas[k].parent], deltas[k].machines) <= quality_bound) accepted.push_back(k);
+    }
+    if(accepted.empty()) return;
+
+    // the first generation starts from the scores of the genes, with the free slot last
+    if(diversity_preserver.first){
+        reset_diversity_scores(diversity_preserver, mu + 1);
+        successors.assign(mu, {});
+        for(int i = 0; i < mu; i++){
+            successor_table(genes[i], successors[i]);
+        }
+        for(int i = 0; i < mu; i++){
+            for(int j = i + 1; j < mu; j++){
+                set_diversity_score(diversity_preserver, i, j, common_successors(successors[i], genes[j]));
+            }
+        }
+        diversity_preserver.index = mu;
+    }
+
+    // the pool: the genes 0, ..., mu - 1 (scores in the preserver) followed by the accepted offspring (scores in offspring_scores)
+    int free_slot = diversity_preserver.index;
+    int size = mu + accepted.size();
+    auto slot = [free_slot](int gene) -> int { return gene < free_slot ? gene : gene + 1; };
+    thread_local std::vector<int> offspring_scores;
+    offspring_scores.assign(accepted.size() * size, 0);
+    auto score = [&](int i, int j) -> int {
+        if(i >= mu) return offspring_scores[(i - mu) * size + j];
+        if(j >= mu) return offspring_scores[(j - mu) * size + i];
+        return diversity_preserver.score(slot(i), slot(j));
+    };
+
+    // score of an individual with the successor table successors to the offspring, given its score to the parent of the offspring
+    auto derived_score = [](int score, const std::vector<int>& successors, const Offspring_Delta& delta) -> int {
+        for(const auto& change : delta.changes){
+            int successor = successors[change.job];
+            if(change.old_successor != -1 && successor == change.old_successor) score--;
+            if(change.new_successor != -1 && successor == change.new_successor) score++;
+        }
+        return score;
+    };
+    thread_local std::vector<std::vector<int>> offspring_successors;
+    offspring_successors.resize(accepted.size());
+    for(int a = 0; a < (int) accepted.size(); a++){
+        const Offspring_Delta& delta = deltas[accepted[a]];
+        int parent_edges = n;
+        for(const auto& machine : genes[delta.parent]){
+            if(machine.size() > 0) parent_edges--;
+        }
+        offspring_successors[a] = successors[delta.parent];
+        for(const auto& change : delta.changes){
+            offspring_successors[a][change.job] = change.new_successor;
+        }
+        int* row = &offspring_scores[a * size];
+        for(int i = 0; i < mu; i++){
+            row[i] = derived_score(i == delta.parent ? parent_edges : score(i, delta.parent), successors[i], delta);
+        }
+        for(int b = 0; b < a; b++){
+            row[mu + b] = offspring_scores[b * size + mu + a] = derived_score(offspring_scores[b * size + delta.parent], offspring_successors[b], delta);
+        }
+    }
+
+    // selection on the sums of squared scores of the individuals of the pool in the population, removing the individual with the highest sum
+    // leaves the lowest sum of squared scores (the highest diversity)
+    thread_local std::vector<char> active;
+    thread_local std::vector<long long> squared_row_sums;
+    active.assign(size, false);
+    squared_row_sums.assign(size, 0);
+    for(int i = 0; i < mu; i++){
+        long long free_score = diversity_preserver.score(slot(i), free_slot);
+        squared_row_sums[i] = diversity_preserver.squared_row_sums[slot(i)] - free_score * free_score;
+        active[i] = true;
+    }
+    auto join = [&](int individual) {
+        for(int i = 0; i < size; i++){
+            if(!active[i]) continue;
+            long long squared_score = (long long) score(i, individual) * score(i, individual);
+            squared_row_sums[i] += squared_score;
+            squared_row_sums[individual] += squared_score;
+        }
+        active[individual] = true;
+    };
+    // ties are broken uniformly at random in one pass
+    auto remove = [&]() -> int {
+        int best_individual = -1;
+        int ties = 0;
+        for(int i = 0; i < size; i++){
+            if(!active[i]) continue;
+            if(best_individual == -1 || squared_row_sums[i] > squared_row_sums[best_individual]){
+                best_individual = i;
+                ties = 1;
+            }else if(squared_row_sums[i] == squared_row_sums[best_individual] && std::uniform_int_distribution<int>(0, ties++)(generator) == 0){
+                best_individual = i;
+            }
+        }
+        active[best_individual] = false;
+        for(int i = 0; i < size; i++){
+            if(active[i]) squared_row_sums[i] -= (long long) score(i, best_individual) * score(i, best_individual);
+        }
+        return best_individual;
+    };
+    int removed = -1;
+    if(greedy){
+        for(int a = 0; a < (int) accepted.size(); a++) join(mu + a);
+        for(int a = 0; a < (int) accepted.size(); a++) removed = remove();
+    }else{
+        for(int a = 0; a < (int) accepted.size(); a++){
+            join(mu + a);
+            removed = remove();
+        }
+    }
+
+    // the surviving offspring (and the individual removed last, if it is an offspring) take the free slot and the slots of the removed genes,
+    // in ascending order, the individual removed last becomes the free slot
+    thread_local std::vector<int> contents;
+    thread_local std::vector<int> free_slots;
+    contents.resize(mu + 1);
+    free_slots.assign(1, free_slot);
+    for(int i = 0; i < mu; i++){
+        contents[slot(i)] = i;
+        if(!active[i] && i != removed) free_slots.push_back(slot(i));
+    }
+    std::sort(free_slots.begin(), free_slots.end());
+    int next_free = 0;
+    for(int a = 0; a < (int) accepted.size(); a++){
+        if(active[mu + a] || mu + a == removed) contents[free_slots[next_free++]] = mu + a;
+    }
+    assert(next_free == (int) free_slots.size());
+    for(int changed : free_slots){
+        for(int i = 0; i <= mu; i++){
+            if(i != changed) set_diversity_score(diversity_preserver, changed, i, score(contents[changed], contents[i]));
+        }
+    }
+    diversity_preserver.index = removed < mu ? slot(removed) : std::find(contents.begin(), contents.end(), removed) - contents.begin();
+    diversity_preserver.first = false;
+
+    // genes, successor tables and schedules in the order of the slots
+    thread_local std::vector<Schedule_Cache> offspring_schedules;
+    offspring_schedules.resize(evaluation != nullptr ? accepted.size() : 0);
+    for(int a = 0; a < (int) offspring_schedules.size(); a++){
+        if(!active[mu + a]) continue;
+        const Offspring_Delta& delta = deltas[accepted[a]];
+        offspring_schedules[a] = schedules[delta.parent];
+        evaluation->update(offspring[accepted[a]], offspring_schedules[a], delta.machines);
+    }
+    std::vector<G>& selected_genes = diversity_preserver.spare_genes;
+    thread_local std::vector<std::vector<int>> selected_successors;
+    thread_local std::vector<Schedule_Cache> selected_schedules;
+    selected_genes.resize(mu);
+    selected_successors.resize(mu);
+    selected_schedules.resize(evaluation != nullptr ? mu : 0);
+    for(int i = 0; i < mu; i++){
+        int individual = contents[i < diversity_preserver.index ? i : i + 1];
+        if(individual < mu){
+            std::swap(selected_genes[i], genes[individual]);
+            std::swap(selected_successors[i], successors[individual]);
+            if(evaluation != nullptr) std::swap(selected_schedules[i], schedules[individual]);
+        }else{
+            selected_genes[i] = offspring[accepted[individual - mu]];
+            std::swap(selected_successors[i], offspring_successors[individual - mu]);
+            if(evaluation != nullptr) std::swap(selected_schedules[i], offspring_schedules[individual - mu]);
+        }
+    }
+    genes.swap(selected_genes);
+    successors.swap(selected_successors);
+    if(evaluation != nullptr) schedules.swap(selected_schedules);
+}
+
+/*
+    pdiv-Selection (batch): pdiv-Selection (batch delta) of the offspring of a generation
+    Arguments:
+        - greedy:               whether all offspring join before the lambda removals, otherwise pdiv-Selection is applied to one offspring after another
+*/
+template <typename G = T>
+std::function<void(std::vector<G>&, const std::vector<G>&, const std::vector<Offspring_Delta>&, Diversity_Preserver<G>&, std::mt19937&)> select_pdiv_batch(bool greedy) {
+    return [greedy](std::vector<G>& genes, const std::vector<G>& offspring, const std::vector<Offspring_Delta>& deltas, Diversity_Preserver<G>& diversity_preserver, std::mt19937& generator) -> void {
+        pdiv_delta_batch(genes, offspring, deltas, diversity_preserver, generator, greedy);
+    };
+}
+
+/*
+    qpdiv-Selection (batch): pdiv-Selection (batch delta) of the offspring of a generation with a fitness of at most alpha * ( n - OPT ) + OPT
+    Arguments:
+        - alpha:                parameter for quality threshold
+        - n:                    number of jobs
+        - OPT:                  fitness value of optimal solution
+        - evaluation:           incremental fitness function
+        - greedy:               whether all offspring join before the lambda removals, otherwise pdiv-Selection is applied to one offspring after another
+*/
+template <typename G = T>
+std::function<void(std::vector<G>&, const std::vector<G>&, const std::vector<Offspring_Delta>&, Diversity_Preserver<G>&, std::mt19937&)> select_qpdiv_batch(double alpha, int n, double OPT, Incremental_Evaluation<G> evaluation, bool greedy) {
+    return [alpha, n, OPT, evaluation, greedy](std::vector<G>& genes, const std::vector<G>& offspring, const std::vector<Offspring_Delta>& deltas, Diversity_Preserver<G>& diversity_preserver, std::mt19937& generator) -> void {
+        pdiv_delta_batch(genes, offspring, deltas, diversity_preserver, generator, greedy, alpha * ( n - OPT ) + OPT, &evaluation);
+    };
+}
+
 /*
     pmu-Selection: Selects the mu (=parent size) individuals with the highest fitness from the combined population of parents and offspring
     Arguments:
@@ -230,11 +687,12 @@ std::function<Diversity_Preserver<T>(const std::vector<T>&, const T&, const Dive
         - evaluate: function taking a vector of genes and returning a vector of fitnesses
 */
 
-std::function<Diversity_Preserver<T>(const std::vector<T>&, const std::vector<L>&, const std::vector<T>&, const Diversity_Preserver<T>&, std::mt19937&)> select_pmu(int mu, std::function<std::vector<L>(const std::vector<T>&)> evaluate) {
+template <typename G = T>
+std::function<void(std::vector<G>&, const std::vector<L>&, const std::vector<G>&, Diversity_Preserver<G>&, std::mt19937&)> select_pmu(int mu, std::function<std::vector<L>(const std::vector<G>&)> evaluate) {
     auto select = select_mu(mu, evaluate);
-    return [select](const std::vector<T>& parents, const std::vector<L>& fitnesses, const std::vector<T>& offspring, const Diversity_Preserver<T>& diversity_preserver, std::mt19937& generator) -> Diversity_Preserver<T> {
-        std::vector<T> genes = select(parents, fitnesses, offspring, generator);
-        return { 0, true, std::map<std::tuple<int, int>, double>(), genes };
+    return [select](std::vector<G>& genes, const std::vector<L>& fitnesses, const std::vector<G>& offspring, Diversity_Preserver<G>& diversity_preserver, std::mt19937& generator) -> void {
+        genes = select(genes, fitnesses, offspring, generator);
+        diversity_preserver = initial_diversity_preserver<G>();
     };
 }
 
@@ -243,9 +701,35 @@ std::function<Diversity_Preserver<T>(const std::vector<T>&, const std::vector<L>
     Arguments
         - diversity_measure:    function taking two genes and returning a double representing the diversity
 */
-std::function<Diversity_Preserver<T>(const std::vector<T>&, const std::vector<L>&, const std::vector<T>&, const Diversity_Preserver<T>&, std::mt19937&)> select_npdiv(std::function<double(const T&, const T&)> diversity_measure) {
+template <typename G = T>
+std::function<void(std::vector<G>&, const std::vector<L>&, const std::vector<G>&, Diversity_Preserver<G>&, std::mt19937&)> select_npdiv(std::function<double(const G&, const G&)> diversity_measure) {
     auto select = select_pdiv(diversity_measure);
-    return [select](const std::vector<T>& parents, const std::vector<L>& fitnesses, const std::vector<T>& offspring, const Diversity_Preserver<T>& diversity_preserver, std::mt19937& generator) -> Diversity_Preserver<T> {
-        return select(parents, offspring[0], diversity_preserver, generator);
+    return [select](std::vector<G>& genes, const std::vector<L>& fitnesses, const std::vector<G>& offspring, Diversity_Preserver<G>& diversity_preserver, std::mt19937& generator) -> void {
+        select(genes, offspring[0], diversity_preserver, generator);
     };
-}
\ No newline at end of file
+}
+
+// Survivor selection policies -----------------------------------------------------
+
+/*
+    Policy types of the delta selections for the statically composed Population_Static
+    Arguments: see the corresponding operators, evaluate is an incremental evaluation policy (e.g. Evaluate_TardyJobs)
+*/
+
+template <typename G = T>
+struct Select_PDiv_Delta {
+    void operator()(std::vector<G>& genes, const G& offspring, const Offspring_Delta& delta, Diversity_Preserver<G>& diversity_preserver, std::mt19937& generator) const {
+        pdiv_delta(genes, offspring, delta, diversity_preserver, generator);
+    }
+};
+
+template <typename G, typename Evaluate>
+struct Select_QPDiv_Delta {
+    double alpha;
+    int n;
+    double OPT;
+    Evaluate evaluate;
+    void operator()(std::vector<G>& genes, const G& offspring, const Offspring_Delta& delta, Diversity_Preserver<G>& diversity_preserver, std::mt19937& generator) const {
+        qpdiv_delta(genes, offspring, delta, diversity_preserver, generator, alpha * ( n - OPT ) + OPT, evaluate);
+    }
+};
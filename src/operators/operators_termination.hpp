@@ -2,9 +2,12 @@
 
 #include <functional>
 #include <vector>
+#include <chrono>
+#include <string>
 
 #include "../population/population.hpp"
 #include "../operators/operators_diversity.hpp"
+#include "../population/trajectory.hpp"
 
 using T = std::vector<std::vector<int>>;
 using L = double;
@@ -16,24 +19,28 @@ using L = double;
     Args:
         max_generations: maximum number of generations
 */
-std::function<bool(Population<T,L>&)> terminate_generations(int max_generations){
-    return [max_generations](Population<T,L>& population) -> bool {
+template <typename G = T>
+std::function<bool(Population<G,L>&)> terminate_generations(int max_generations){
+    return [max_generations](Population<G,L>& population) -> bool {
         return population.get_generation() >= max_generations;
     };
 }
 
 /*
     Diversity termination: Terminate when the diversity is higher / lower than a certain threshold.
+    Populations maintaining their diversity (Population_Mu1) are checked in O(1).
     Args:
         threshold:          threshold for the diversity
         higher:             whether to terminate when the diversity is higher or lower than the threshold
         diversity_measure:  diversity measure to use
 */
-std::function<bool(Population<T,L>&)> terminate_diversity(double threshold, bool higher, std::function<double(const T&, const T&)> diversity_measure){
-    std::function<double(const std::vector<T>&)> div_vector = diversity_vector(diversity_measure);
-    return [div_vector, higher, threshold](Population<T,L>& population) -> bool {
-        if(div_vector(population.get_genes(true)) == threshold) return true;
-        return higher == (div_vector(population.get_genes(true)) > threshold);
+template <typename G = T>
+std::function<bool(Population<G,L>&)> terminate_diversity(double threshold, bool higher, std::function<double(const G&, const G&)> diversity_measure){
+    std::function<double(const std::vector<G>&)> div_vector = diversity_vector(diversity_measure);
+    return [div_vector, higher, threshold](Population<G,L>& population) -> bool {
+        double diversity = population.get_diversity(div_vector);
+        if(diversity == threshold) return true;
+        return higher == (diversity > threshold);
     };
 }
 
@@ -44,11 +51,88 @@ std::function<bool(Population<T,L>&)> terminate_diversity(double threshold, bool
         diversity_measure:  diversity measure to use
         max_generations:    maximum number of generations
 */
-std::function<bool(Population<T,L>&)> terminate_diversitygenerations(double threshold, bool higher, std::function<double(const T&, const T&)> diversity_measure, int max_generations){
-    std::function<double(const std::vector<T>&)> div_vector = diversity_vector(diversity_measure);
-    return [div_vector, higher, threshold, max_generations](Population<T,L>& population) -> bool {
+template <typename G = T>
+std::function<bool(Population<G,L>&)> terminate_diversitygenerations(double threshold, bool higher, std::function<double(const G&, const G&)> diversity_measure, int max_generations){
+    std::function<double(const std::vector<G>&)> div_vector = diversity_vector(diversity_measure);
+    return [div_vector, higher, threshold, max_generations](Population<G,L>& population) -> bool {
         if(population.get_generation() >= max_generations) return true;
-        if(div_vector(population.get_genes(true)) == threshold) return true;
-        return higher == (div_vector(population.get_genes(true)) > threshold);
+        double diversity = population.get_diversity(div_vector);
+        if(diversity == threshold) return true;
+        return higher == (diversity > threshold);
     };
-}
\ No newline at end of file
+}
+
+/*
+    Checkpointing termination: Terminate as termination_criterion, saving the state of the population to checkpoint_file
+    whenever interval seconds have passed since the last save (the state is saved before the generation is executed)
+    Args:
+        termination_criterion:  termination criterion to use
+        checkpoint_file:        file of the checkpoint, replaced atomically on every save
+        interval:               seconds between two saves
+*/
+template <typename G = T>
+std::function<bool(Population<G,L>&)> terminate_checkpointing(std::function<bool(Population<G,L>&)> termination_criterion, std::string checkpoint_file, double interval = 600){
+    auto last_save = std::chrono::steady_clock::now();
+    return [termination_criterion, checkpoint_file, interval, last_save](Population<G,L>& population) mutable -> bool {
+        if(termination_criterion(population)) return true;
+        auto now = std::chrono::steady_clock::now();
+        if(std::chrono::duration<double>(now - last_save).count() >= interval){
+            save_checkpoint(population, checkpoint_file);
+            last_save = now;
+        }
+        return false;
+    };
+}
+
+/*
+    Recording termination: Terminate as termination_criterion, recording the trajectory of the population into recorder
+    (the generations sampled by it and the last generation, see Trajectory_Recorder), the recorder is flushed when the run terminates
+    Recording takes the best fitness, so populations not consuming their fitness evaluate their offspring from then on
+    Args:
+        termination_criterion:  termination criterion to use
+        recorder:               recorder of the run
+        diversity_value:        diversity of a vector of genes
+        evaluate:               evaluation function of the best fitness
+*/
+template <typename G = T>
+std::function<bool(Population<G,L>&)> terminate_recording(std::function<bool(Population<G,L>&)> termination_criterion, Trajectory_Recorder& recorder, std::function<double(const std::vector<G>&)> diversity_value, std::function<std::vector<L>(const std::vector<G>&)> evaluate){
+    return [termination_criterion, &recorder, diversity_value, evaluate](Population<G,L>& population) mutable -> bool {
+        bool terminate = termination_criterion(population);
+        int generation = population.get_generation();
+        bool change = recorder.get_sampling().mode == Trajectory_Sampling::Mode::change;
+        if(terminate || change || recorder.sampled(generation)){
+            double diversity = population.get_diversity(diversity_value);
+            L best_fitness = population.get_best_fitness(evaluate);
+            if(terminate || !change || recorder.changed(diversity, best_fitness)){
+                recorder.record(generation, diversity, best_fitness, population.get_size(false));
+            }
+        }
+        if(terminate) recorder.flush();
+        return terminate;
+    };
+}
+
+// Termination policies -------------------------------------------------------
+
+/*
+    Diversity or generation termination policy: same as Diversity or generation termination, for the statically composed Population_Static
+    Args:
+        threshold:          threshold for the diversity
+        higher:             whether to terminate when the diversity is higher or lower than the threshold
+        max_generations:    maximum number of generations
+        div_vector:         diversity of a vector of genes, used until the population maintains its diversity itself
+*/
+template <typename G = T>
+struct Terminate_DiversityGenerations {
+    double threshold;
+    bool higher;
+    int max_generations;
+    std::function<double(const std::vector<G>&)> div_vector;
+    template <typename P>
+    bool operator()(P& population) const {
+        if(population.get_generation() >= max_generations) return true;
+        double diversity = population.get_diversity(div_vector);
+        if(diversity == threshold) return true;
+        return higher == (diversity > threshold);
+    }
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <type_traits>
+
+// Components of a generation (and the termination check before it), recorded by Population::execute
+enum class Component { evaluate, selectParents, recombine, mutate, selectSurvivors, termination };
+
+// Recording of the components of a generation: none, only their calls, or their calls and time
+enum class Recording { off, counted, timed };
+
+/*
+    Number of calls and wall time (steady clock) per component over the generations of a run
+    The calls are counted in every generation, the time is only taken every sampling_interval-th generation (keeping the clock reads off the others)
+    and extrapolated to all calls by get_component_times_columns
+    Evaluations inside a survivor selection (e.g. the quality gate of qpdiv) count towards selectSurvivors
+*/
+struct Component_Times {
+    static constexpr int components = 6;
+    static constexpr const char* names[components] = {"evaluate", "selectParents", "recombine", "mutate", "selectSurvivors", "termination"};
+
+    int sampling_interval = 16;
+    std::array<long long, components> calls{};
+    std::array<long long, components> timed_calls{};
+    std::array<long long, components> nanoseconds{};   // of the timed calls
+
+    // recording of the generation following generation
+    Recording recording(int generation) const {
+        return generation % sampling_interval == 0 ? Recording::timed : Recording::counted;
+    }
+
+    // estimated time of all calls of component in nanoseconds
+    long long estimated_nanoseconds(int component) const {
+        return timed_calls[component] == 0 ? 0 : (long long) ((double) nanoseconds[component] * calls[component] / timed_calls[component]);
+    }
+};
+
+// csv columns of Component_Times, ",<component>_ns,<component>_calls" per component
+std::string get_component_times_header() {
+    std::string header;
+    for(const char* name : Component_Times::names) header += std::string(",") + name + "_ns," + name + "_calls";
+    return header;
+}
+
+std::string get_component_times_columns(const Component_Times& times) {
+    std::string columns;
+    for(int i = 0; i < Component_Times::components; i++) columns += "," + std::to_string(times.estimated_nanoseconds(i)) + "," + std::to_string(times.calls[i]);
+    return columns;
+}
+
+/*
+    Calls function and returns its result, counting the call of component in times (Recording::counted) and timing it (Recording::timed)
+    With Recording::off nothing is recorded, so the generations compile to the same code as without instrumentation
+*/
+template <Recording recording, typename Function>
+decltype(auto) record_component(Component_Times* times, Component component, Function&& function) {
+    if constexpr (recording == Recording::off){
+        return function();
+    }else if constexpr (recording == Recording::counted){
+        times->calls[int(component)]++;
+        return function();
+    }else{
+        times->calls[int(component)]++;
+        times->timed_calls[int(component)]++;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if constexpr (std::is_void_v<decltype(function())>){
+            function();
+            times->nanoseconds[int(component)] += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        }else{
+            decltype(auto) result = function();
+            times->nanoseconds[int(component)] += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            return result;
+        }
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <assert.h>
+
+/*
+    Flat machine schedule: gene layout keeping a whole parallel machine schedule in one contiguous buffer,
+    the m+1 machine offsets followed by the jobs of all machines, machine i holding the jobs in [offsets[i], offsets[i+1])
+    Offers the part of the std::vector<std::vector<int>> interface used by the operators (size, operator[], iteration over machines),
+    with machines being views into the buffer, so copying a gene is a single allocation
+    The buffer is allocated by Allocator (see gene_pool.hpp for a pooled one)
+*/
+
+template <typename Allocator = std::allocator<int>>
+class Basic_Flat_Schedule {
+
+public:
+
+    // View of the jobs of one machine
+    template <typename J>
+    class Machine {
+        J* first;
+        J* last;
+    public:
+        Machine(J* first, J* last) : first(first), last(last) {}
+        size_t size() const { return last - first; }
+        bool empty() const { return first == last; }
+        J& operator[](size_t i) const { return first[i]; }
+        J* begin() const { return first; }
+        J* end() const { return last; }
+    };
+
+    // Iterator over the machines of a schedule
+    template <typename S, typename J>
+    class Machine_Iterator {
+        S* schedule;
+        size_t machine;
+    public:
+        Machine_Iterator(S* schedule, size_t machine) : schedule(schedule), machine(machine) {}
+        Machine<J> operator*() const { return (*schedule)[machine]; }
+        Machine_Iterator& operator++() { machine++; return *this; }
+        bool operator!=(const Machine_Iterator& other) const { return machine != other.machine; }
+    };
+
+    Basic_Flat_Schedule() : machines(0), data(1, 0) {}
+
+    // Creates an empty schedule for machines_n machines
+    explicit Basic_Flat_Schedule(int machines_n) : machines(machines_n), data(machines_n + 1, 0) {}
+
+    explicit Basic_Flat_Schedule(const std::vector<std::vector<int>>& gene) : machines(gene.size()), data(gene.size() + 1, 0) {
+        for (size_t i = 0; i < gene.size(); i++) {
+            data[i + 1] = data[i] + gene[i].size();
+            data.insert(data.end(), gene[i].begin(), gene[i].end());
+        }
+    }
+
+    // number of machines
+    size_t size() const { return machines; }
+
+    Machine<int> operator[](size_t machine) { return { jobs() + data[machine], jobs() + data[machine + 1] }; }
+    Machine<const int> operator[](size_t machine) const { return { jobs() + data[machine], jobs() + data[machine + 1] }; }
+
+    Machine_Iterator<Basic_Flat_Schedule, int> begin() { return { this, 0 }; }
+    Machine_Iterator<Basic_Flat_Schedule, int> end() { return { this, size() }; }
+    Machine_Iterator<const Basic_Flat_Schedule, const int> begin() const { return { this, 0 }; }
+    Machine_Iterator<const Basic_Flat_Schedule, const int> end() const { return { this, size() }; }
+
+    /*
+        Removes the job at position job_remove of machine_remove and inserts it at position job_insert of machine_insert,
+        where job_insert refers to machine_insert after the removal (same semantics as erase followed by insert on nested vectors)
+        Only the jobs between both positions are shifted
+    */
+    void move_job(int machine_remove, int job_remove, int machine_insert, int job_insert) {
+        int m = machines;
+        int* offsets = data.data();
+        int from = offsets[machine_remove] + job_remove;
+        int to = offsets[machine_insert] + job_insert - (machine_insert > machine_remove ? 1 : 0);
+        assert(from < offsets[m] && to < offsets[m]);
+        int* job_array = jobs();
+        if (from < to) std::rotate(job_array + from, job_array + from + 1, job_array + to + 1);
+        else if (to < from) std::rotate(job_array + to, job_array + from, job_array + from + 1);
+        for (int i = machine_remove + 1; i <= m; i++) offsets[i]--;
+        for (int i = machine_insert + 1; i <= m; i++) offsets[i]++;
+    }
+
+    std::vector<std::vector<int>> to_nested() const {
+        std::vector<std::vector<int>> gene(size());
+        for (size_t i = 0; i < size(); i++) gene[i].assign((*this)[i].begin(), (*this)[i].end());
+        return gene;
+    }
+
+    bool operator==(const Basic_Flat_Schedule& other) const { return machines == other.machines && data == other.data; }
+    bool operator!=(const Basic_Flat_Schedule& other) const { return !(*this == other); }
+
+    // Same order as on nested vectors: lexicographical over the machines, each compared lexicographically
+    bool operator<(const Basic_Flat_Schedule& other) const {
+        size_t common_machines = std::min(size(), other.size());
+        for (size_t i = 0; i < common_machines; i++) {
+            Machine<const int> machine1 = (*this)[i], machine2 = other[i];
+            if (std::lexicographical_compare(machine1.begin(), machine1.end(), machine2.begin(), machine2.end())) return true;
+            if (std::lexicographical_compare(machine2.begin(), machine2.end(), machine1.begin(), machine1.end())) return false;
+        }
+        return size() < other.size();
+    }
+
+private:
+
+    int machines;
+    std::vector<int, Allocator> data;
+
+    int* jobs() { return data.data() + size() + 1; }
+    const int* jobs() const { return data.data() + size() + 1; }
+};
+
+using Flat_Schedule = Basic_Flat_Schedule<>;
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <vector>
+#include <new>
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <assert.h>
+
+#include "flat_schedule.hpp"
+
+/*
+    Gene pool: per run slab allocator for the memory of genes
+    Blocks are carved from slabs sized from (mu, n, m) and grouped in power of two size classes, freed blocks are kept in a free list of their class
+    and handed out again, all slabs are released at once with the pool
+    A pool is installed for the current thread by a Gene_Pool_Scope, so concurrent runs (one per OpenMP thread) never share a pool or contend on malloc
+*/
+
+class Gene_Pool {
+
+public:
+
+    // Slabs hold the genes of a population of size mu with n jobs on m machines, plus room for offspring and the growth of machines
+    Gene_Pool(int mu, int n, int m) : slab_size(std::max<size_t>(min_slab_size, round_up(4 * (mu + 2) * (n + 2 * m) * sizeof(int)))) {}
+
+    ~Gene_Pool() {
+        for(char* slab : slabs) ::operator delete(slab);
+    }
+
+    Gene_Pool(const Gene_Pool&) = delete;
+    Gene_Pool& operator=(const Gene_Pool&) = delete;
+
+    void* allocate(size_t bytes) {
+        size_t block_size = round_up(bytes);
+        if(block_size > slab_size / 4) return ::operator new(bytes);
+        int size_class = get_size_class(block_size);
+        if(free_lists[size_class] != nullptr){
+            Free_Block* block = free_lists[size_class];
+            free_lists[size_class] = block->next;
+            return block;
+        }
+        if(remaining < block_size){
+            slabs.push_back(static_cast<char*>(::operator new(slab_size)));
+            current = slabs.back();
+            remaining = slab_size;
+        }
+        void* block = current;
+        current += block_size;
+        remaining -= block_size;
+        return block;
+    }
+
+    void deallocate(void* pointer, size_t bytes) {
+        size_t block_size = round_up(bytes);
+        if(block_size > slab_size / 4){
+            ::operator delete(pointer);
+            return;
+        }
+        assert(owns(pointer) && "block returned to a gene pool it was not taken from");
+        int size_class = get_size_class(block_size);
+        Free_Block* block = static_cast<Free_Block*>(pointer);
+        block->next = free_lists[size_class];
+        free_lists[size_class] = block;
+    }
+
+    // pool installed for the current thread, nullptr if none
+    static Gene_Pool*& current_pool() {
+        thread_local Gene_Pool* pool = nullptr;
+        return pool;
+    }
+
+private:
+
+    struct Free_Block {
+        Free_Block* next;
+    };
+
+    static constexpr size_t min_block_size = 16;
+    static constexpr size_t min_slab_size = 1 << 16;
+    static constexpr int size_classes = 64;
+
+    size_t slab_size;
+    std::vector<char*> slabs;
+    char* current = nullptr;
+    size_t remaining = 0;
+    Free_Block* free_lists[size_classes] = {};
+
+    // smallest power of two of at least min_block_size bytes holding bytes
+    static size_t round_up(size_t bytes) {
+        size_t block_size = min_block_size;
+        while(block_size < bytes) block_size <<= 1;
+        return block_size;
+    }
+
+    static int get_size_class(size_t block_size) {
+        int size_class = 0;
+        while(block_size > min_block_size){
+            block_size >>= 1;
+            size_class++;
+        }
+        return size_class;
+    }
+
+    // whether pointer lies in one of the slabs of the pool
+    bool owns(const void* pointer) const {
+        const char* address = static_cast<const char*>(pointer);
+        return std::any_of(slabs.begin(), slabs.end(), [&](const char* slab) { return slab <= address && address < slab + slab_size; });
+    }
+};
+
+/*
+    Installs a gene pool for (mu, n, m) for the current thread during its lifetime, the previously installed pool is restored afterwards
+    Genes allocated by Pool_Allocator within the scope must not outlive it
+*/
+class Gene_Pool_Scope {
+
+public:
+
+    Gene_Pool_Scope(int mu, int n, int m) : pool(mu, n, m), previous(Gene_Pool::current_pool()) {
+        Gene_Pool::current_pool() = &pool;
+    }
+
+    ~Gene_Pool_Scope() {
+        assert(Gene_Pool::current_pool() == &pool && "gene pool scopes must be nested");
+        Gene_Pool::current_pool() = previous;
+    }
+
+    Gene_Pool_Scope(const Gene_Pool_Scope&) = delete;
+    Gene_Pool_Scope& operator=(const Gene_Pool_Scope&) = delete;
+
+private:
+
+    Gene_Pool pool;
+    Gene_Pool* previous;
+};
+
+/*
+    Allocator taking memory from the gene pool installed for the current thread when it is constructed, or from the heap if none is installed
+    Containers keep their allocator, so memory always returns to the pool it came from, also when it is freed after another pool was installed
+*/
+template <typename U>
+struct Pool_Allocator {
+
+    using value_type = U;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    Gene_Pool* pool = Gene_Pool::current_pool();
+
+    Pool_Allocator() = default;
+    template <typename V>
+    Pool_Allocator(const Pool_Allocator<V>& other) : pool(other.pool) {}
+
+    U* allocate(size_t count) {
+        if(pool == nullptr) return static_cast<U*>(::operator new(count * sizeof(U)));
+        return static_cast<U*>(pool->allocate(count * sizeof(U)));
+    }
+
+    void deallocate(U* pointer, size_t count) {
+        if(pool == nullptr) ::operator delete(pointer);
+        else pool->deallocate(pointer, count * sizeof(U));
+    }
+
+    template <typename V>
+    bool operator==(const Pool_Allocator<V>& other) const { return pool == other.pool; }
+    template <typename V>
+    bool operator!=(const Pool_Allocator<V>& other) const { return pool != other.pool; }
+};
+
+// Gene layouts with pooled memory
+using Pooled_Machine = std::vector<int, Pool_Allocator<int>>;
+using Pooled_Schedule = std::vector<Pooled_Machine, Pool_Allocator<Pooled_Machine>>;
+using Pooled_Flat_Schedule = Basic_Flat_Schedule<Pool_Allocator<int>>;
+
+// Converts a gene in the nested layout to the layout G
+template <typename G>
+G make_gene(const std::vector<std::vector<int>>& gene) {
+    if constexpr (std::is_constructible_v<G, const std::vector<std::vector<int>>&>){
+        return G(gene);
+    }else{
+        G converted_gene(gene.size());
+        for(size_t i = 0; i < gene.size(); i++) converted_gene[i].assign(gene[i].begin(), gene[i].end());
+        return converted_gene;
+    }
+}
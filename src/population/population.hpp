@@ -4,17 +4,90 @@
 #include <functional>
 #include <random>
 #include <assert.h>
-#include <map>
-#include <tuple>
+#include <cstdint>
+#include <fstream>
+#include <cstdio>
+#include <cerrno>
+#include <sstream>
+#include <iostream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
 
+#include "serialization.hpp"
+#include "component_times.hpp"
+
+// Change of the successor of job (the job directly following it on its machine, -1 if none) caused by a mutation
+struct Edge_Change {
+    int job;
+    int old_successor;
+    int new_successor;
+};
+
+// Positions first to last (-1: to the end of the machine) of machine changed by a mutation, the jobs on the other positions keep their completion times
+struct Machine_Change {
+    int machine;
+    int first;
+    int last;
+};
+
+// Offspring created by a mutation of the parent with the given index, differing from it in the listed edge changes and machine positions
+struct Offspring_Delta {
+    int parent;
+    std::vector<Edge_Change> changes;
+    std::vector<Machine_Change> machines;
+};
+
+// Completion times and tardiness of the jobs of a gene per machine and position, with the number of tardy jobs per machine
+struct Schedule_Cache {
+    std::vector<std::vector<int>> completion_times;
+    std::vector<std::vector<uint8_t>> tardy;
+    std::vector<int> tardy_jobs;
+};
+
+void write_binary(std::ostream& out, const Schedule_Cache& cache) {
+    write_binary(out, cache.completion_times);
+    write_binary(out, cache.tardy);
+    write_binary(out, cache.tardy_jobs);
+}
+
+void read_binary(std::istream& in, Schedule_Cache& cache) {
+    read_binary(in, cache.completion_times);
+    read_binary(in, cache.tardy);
+    read_binary(in, cache.tardy_jobs);
+}
+
+/*
+    State of the diversity preserving survivor selections, updated in place every generation:
+    the genes of the population together with the slot index of the last removed individual form size = mu + 1 slots, the next offspring takes that slot
+*/
 template <typename T>
 struct Diversity_Preserver {
     int index;
     bool first;
-    std::map<std::tuple<int, int>, double> diversity_scores;
-    std::vector<T> genes;
+    int size;
+    std::vector<int> diversity_scores;              // size x size matrix of the pairwise diversity scores of the slots, row major
+    std::vector<std::vector<uint64_t>> encodings;   // cached edge encodings of genes, only maintained by delta selections working on an Edge_Diversity
+    std::vector<std::vector<int>> successors;       // cached successor tables of genes, only maintained by delta selections
+    std::vector<Schedule_Cache> schedules;          // cached schedules of genes (in the order of genes), only maintained by quality gated delta selections
+    T spare_gene;                                   // memory of the last removed gene, reused for the next offspring by delta selections
+    std::vector<int> spare_successors;              // memory of the last removed successor table, likewise
+    std::vector<uint64_t> spare_encoding;           // memory of the last removed edge encoding, likewise
+    std::vector<T> spare_genes;                     // memory of the genes replaced by the last batch selection, likewise (pooled genes must not outlive their run)
+    std::vector<long long> squared_row_sums;        // per slot, sum of its squared diversity scores
+    long long squared_sum;                          // sum of all squared diversity scores
+    bool offspring_evaluated;                       // whether the last selection evaluated its offspring (quality gated selections), with fitness offspring_fitness
+    double offspring_fitness;
+
+    int& score(int i, int j) { return diversity_scores[i * size + j]; }
 };
 
+// State of a diversity preserving selection before its first generation (first set, no preserved scores), every field initialized
+template <typename T>
+Diversity_Preserver<T> initial_diversity_preserver() {
+    return Diversity_Preserver<T>{0, true, 0, {}, {}, {}, {}, T(), {}, {}, {}, {}, 0, false, 0};
+}
+
 // Class Outline ----------------------------------------------------------------------------------------------------------------------------
 
 template <typename T, typename L> // T: type of genes, L: type of fitness values
@@ -25,6 +98,11 @@ protected:
     std::vector<T> genes;
     std::mt19937 generator;
     int generation;
+    // fitness values of the genes, only up to date if fitnesses_valid is set
+    std::vector<L> fitnesses;
+    bool fitnesses_valid;
+    // whether selectParents or selectSurvivors read the fitness values passed to them, otherwise genes are only evaluated on demand
+    bool consumes_fitness;
 
     // Function taking a vector of genes of type T and returning its fitness value vector of type L
     std::function<std::vector<L>(const std::vector<T>&)>& evaluate;
@@ -37,7 +115,14 @@ protected:
     // Function taking two vectors of genes of type T (parents and children) and returning a selected vector of genes of type T
     std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const std::vector<T>&, std::mt19937&)>& selectSurvivors;
 
+    // calls and time of the components of execute, not recorded if nullptr
+    Component_Times* component_times = nullptr;
+
     std::string gene_to_string(T gene);
+    //executes one iteration, recording its components into component_times as given by recording
+    template <Recording recording> void execute_generation();
+    // returns the fitness values of the genes, evaluating them with evaluate if they are not up to date
+    const std::vector<L>& get_fitnesses(const std::function<std::vector<L>(const std::vector<T>&)>& evaluate);
 
 public:
 
@@ -59,14 +144,19 @@ public:
     virtual void execute();   
     //executes iterations of the evolutionary algorithm until the termination criterion is met                                              
     virtual void execute(std::function<bool(Population<T,L>&)> termination_criterion);   
-    //get maximum fitness value over the course of the algorithm
+    //get maximum fitness value over the course of the algorithm (evaluate has to be the fitness function of the population, as stored fitness values are reused)
     L get_best_fitness(std::function<std::vector<L>(const std::vector<T>&)>& evaluate);                 
-    //returns the best genes in the population, using the given evaluate function
+    //returns the best genes in the population, using the given evaluate function (see get_best_fitness)
     std::vector<T> get_bests(bool keep_duplicats, std::function<std::vector<L>(const std::vector<T>&)>& evaluate);       
     //returns the current genes in the population           
     std::vector<T> get_genes(bool keep_duplicats);   
+    //returns the diversity value of the current genes, computed by diversity_value unless the population maintains it itself
+    virtual double get_diversity(const std::function<double(const std::vector<T>&)>& diversity_value);
     //returns the number of generation that have been executed               
     int get_generation();
+    //writes the state of the population (genes, generator, generation, stored fitness values) to out, load restores it, so that execution continues as if uninterrupted
+    virtual void save(std::ostream& out);
+    virtual void load(std::istream& in);
     //returns the size of the population
     int get_size(bool keep_duplicates);        
     //sets the genes in the population to new_genes                                         
@@ -82,6 +172,10 @@ public:
     void set_mutate(const std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)>& mutate);
     void set_recombine(const std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)>& recombine);
     void set_selectSurvivors(const std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const std::vector<T>&, std::mt19937&)>& selectSurvivors);
+    // declares whether selectParents or selectSurvivors read the fitness values passed to them (default), if not, the genes are not evaluated during execution
+    void set_consumes_fitness(bool consumes_fitness);
+    // records the calls and time of every component of execute into component_times (nullptr: no recording, the default)
+    void set_component_times(Component_Times* component_times);
 };
 
 // Class Implementation ---------------------------------------------------------------------------------------------------------------------
@@ -95,29 +189,47 @@ Population<T, L>::Population(
     std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)>& mutate,
     std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)>& recombine,
     std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const std::vector<T>&, std::mt19937&)>& selectSurvivors
-) : generation(0), generator(seed), evaluate(evaluate), selectParents(selectParents), mutate(mutate), recombine(recombine), selectSurvivors(selectSurvivors) {
+) : generation(0), generator(seed), fitnesses_valid(false), consumes_fitness(true), evaluate(evaluate), selectParents(selectParents), mutate(mutate), recombine(recombine), selectSurvivors(selectSurvivors) {
     assert(initialize != nullptr && evaluate != nullptr && "initialize and evaluate function must be set");
     genes = initialize(generator);
     assert(genes.size() > 0 && "initialize function must return a non-empty vector");
 }
 
 template <typename T, typename L>
-Population<T, L>::Population(){};
+Population<T, L>::Population() : fitnesses_valid(false), consumes_fitness(true) {};
 
 template <typename T, typename L>
 void Population<T, L>::execute() {
+    Recording recording = component_times == nullptr ? Recording::off : component_times->recording(generation);
+    if(recording == Recording::timed) execute_generation<Recording::timed>();
+    else if(recording == Recording::counted) execute_generation<Recording::counted>();
+    else execute_generation<Recording::off>();
+}
+
+template <typename T, typename L>
+template <Recording recording>
+void Population<T, L>::execute_generation() {
     generation++;
-    std::vector<L> fitnesses = (evaluate == nullptr) ? std::vector<L>(0) : evaluate(genes);
-    assert(evaluate == nullptr || fitnesses.size() == genes.size());
-    std::vector<T> parents = (selectParents == nullptr) ? genes : selectParents(genes, fitnesses, generator);
-    std::vector<T> children = (recombine == nullptr) ? parents : recombine(parents, generator);
-    children = (mutate == nullptr) ? children : mutate(children, generator);
-    genes = (selectSurvivors == nullptr) ? children : selectSurvivors(genes, fitnesses, children, generator);
+    std::vector<L> no_fitnesses;
+    const std::vector<L>& fitnesses = (evaluate == nullptr || !consumes_fitness) ? no_fitnesses : record_component<recording>(component_times, Component::evaluate, [&]() -> const std::vector<L>& { return get_fitnesses(evaluate); });
+    assert(evaluate == nullptr || !consumes_fitness || fitnesses.size() == genes.size());
+    std::vector<T> parents = (selectParents == nullptr) ? genes : record_component<recording>(component_times, Component::selectParents, [&]() { return selectParents(genes, fitnesses, generator); });
+    std::vector<T> children = (recombine == nullptr) ? parents : record_component<recording>(component_times, Component::recombine, [&]() { return recombine(parents, generator); });
+    children = (mutate == nullptr) ? children : record_component<recording>(component_times, Component::mutate, [&]() { return mutate(children, generator); });
+    genes = (selectSurvivors == nullptr) ? children : record_component<recording>(component_times, Component::selectSurvivors, [&]() { return selectSurvivors(genes, fitnesses, children, generator); });
+    fitnesses_valid = false;
 }
 
 template <typename T, typename L>
 void Population<T, L>::execute(std::function<bool(Population<T,L>&)> termination_criterion){
-    while(!termination_criterion(*this)){
+    if(component_times == nullptr){
+        while(!termination_criterion(*this)){
+            execute();
+        }
+        return;
+    }
+    auto terminate = [&]() { return termination_criterion(*this); };
+    while(component_times->recording(generation) == Recording::timed ? !record_component<Recording::timed>(component_times, Component::termination, terminate) : !record_component<Recording::counted>(component_times, Component::termination, terminate)){
         execute();
     }
 }
@@ -125,7 +237,7 @@ void Population<T, L>::execute(std::function<bool(Population<T,L>&)> termination
 template <typename T, typename L>
 std::vector<T> Population<T, L>::get_bests(bool keep_duplicats, std::function<std::vector<L>(const std::vector<T>&)>& evaluate){
     std::vector<T> bests;
-    std::vector<L> fitnesses = evaluate(genes);
+    const std::vector<L>& fitnesses = get_fitnesses(evaluate);
     auto min_it = std::min_element(fitnesses.begin(), fitnesses.end());
     for(int i = 0; i < genes.size(); i++){
         if(fitnesses[i] == *min_it){
@@ -142,7 +254,7 @@ std::vector<T> Population<T, L>::get_bests(bool keep_duplicats, std::function<st
 
 template <typename T, typename L>
 L Population<T, L>::get_best_fitness(std::function<std::vector<L>(const std::vector<T>&)>& evaluate){
-    std::vector<L> fitnesses = evaluate(genes);
+    const std::vector<L>& fitnesses = get_fitnesses(evaluate);
     auto min_it = std::min_element(fitnesses.begin(), fitnesses.end());
     return *min_it;
 }
@@ -156,11 +268,48 @@ std::vector<T> Population<T, L>::get_genes(bool keep_duplicats){
     return genes_copy;
 }
 
+template <typename T, typename L>
+const std::vector<L>& Population<T, L>::get_fitnesses(const std::function<std::vector<L>(const std::vector<T>&)>& evaluate){
+    if(!fitnesses_valid){
+        fitnesses = evaluate(genes);
+        fitnesses_valid = true;
+    }
+    assert(fitnesses.size() == genes.size());
+    return fitnesses;
+}
+
+template <typename T, typename L>
+double Population<T, L>::get_diversity(const std::function<double(const std::vector<T>&)>& diversity_value){
+    return diversity_value(genes);
+}
+
 template <typename T, typename L>
 int Population<T, L>::get_generation(){
     return generation;
 }
 
+template <typename T, typename L>
+void Population<T, L>::save(std::ostream& out){
+    write_binary(out, (unsigned long long) genes.size());
+    for(const T& gene : genes) write_gene(out, gene);
+    write_binary(out, generator);
+    write_binary(out, generation);
+    write_binary(out, fitnesses);
+    write_binary(out, fitnesses_valid);
+}
+
+template <typename T, typename L>
+void Population<T, L>::load(std::istream& in){
+    unsigned long long size;
+    read_binary(in, size);
+    genes.resize(size);
+    for(T& gene : genes) read_gene(in, gene);
+    read_binary(in, generator);
+    read_binary(in, generation);
+    read_binary(in, fitnesses);
+    read_binary(in, fitnesses_valid);
+}
+
 template <typename T, typename L>
 int Population<T, L>::get_size(bool keep_duplicates){
     return get_genes(keep_duplicates).size();
@@ -169,6 +318,7 @@ int Population<T, L>::get_size(bool keep_duplicates){
 template <typename T, typename L>
 void Population<T, L>::set_genes(std::vector<T> new_genes){
     genes = new_genes;
+    fitnesses_valid = false;
 }
 
 template <typename T, typename L>
@@ -217,4 +367,54 @@ void Population<T, L>::set_mutate(const std::function<std::vector<T>(const std::
 template <typename T, typename L>
 void Population<T, L>::set_recombine(const std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)>& recombine){ this->recombine = recombine;}
 template <typename T, typename L>
-void Population<T, L>::set_selectSurvivors(const std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const std::vector<T>&, std::mt19937&)>& selectSurvivors){ this->selectSurvivors = selectSurvivors;}
\ No newline at end of file
+void Population<T, L>::set_selectSurvivors(const std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const std::vector<T>&, std::mt19937&)>& selectSurvivors){ this->selectSurvivors = selectSurvivors;}
+template <typename T, typename L>
+void Population<T, L>::set_component_times(Component_Times* component_times){ this->component_times = component_times; }
+template <typename T, typename L>
+void Population<T, L>::set_consumes_fitness(bool consumes_fitness){ this->consumes_fitness = consumes_fitness;}
+
+// Checkpoints ------------------------------------------------------------------------------------------------------------------------------
+
+const std::string checkpoint_magic = "EDO-POPULATION-1";
+
+// Saves the state of population to the file path, replacing it atomically (written to path.tmp and synced to disk first)
+template <typename T, typename L>
+void save_checkpoint(Population<T, L>& population, const std::string& path){
+    std::ostringstream state(std::ios_base::out | std::ios_base::binary);
+    state.write(checkpoint_magic.data(), checkpoint_magic.size());
+    population.save(state);
+    std::string content = state.str();
+    std::string temporary_path = path + ".tmp";
+    int file = ::open(temporary_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(file < 0) throw std::runtime_error("Error opening checkpoint: " + temporary_path);
+    size_t written = 0;
+    while(written < content.size()){
+        ssize_t result = ::write(file, content.data() + written, content.size() - written);
+        if(result < 0 && errno == EINTR) continue;
+        if(result < 0) break;
+        written += result;
+    }
+    bool synced = written == content.size() && ::fsync(file) == 0;
+    ::close(file);
+    if(!synced) throw std::runtime_error("Error writing checkpoint: " + temporary_path);
+    if(std::rename(temporary_path.c_str(), path.c_str()) != 0) throw std::runtime_error("Error replacing checkpoint: " + path);
+}
+
+// Restores the state of population from the file path if it holds a valid checkpoint, returns whether it did (otherwise population is left as it was)
+template <typename T, typename L>
+bool load_checkpoint(Population<T, L>& population, const std::string& path){
+    std::ifstream file(path, std::ios_base::in | std::ios_base::binary);
+    if(!file.is_open()) return false;
+    std::stringstream initial_state(std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    population.save(initial_state);
+    try {
+        std::string magic(checkpoint_magic.size(), '\0');
+        if(!file.read(&magic[0], magic.size()) || magic != checkpoint_magic) throw std::runtime_error("Invalid checkpoint.");
+        population.load(file);
+    } catch(const std::exception& error) {
+        std::cerr << "Ignoring checkpoint " << path << " (" << error.what() << "), restarting the run" << std::endl;
+        population.load(initial_state);
+        return false;
+    }
+    return true;
+}
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <numeric>
+
 #include "population.hpp"
+#include "../operators/operators_diversity.hpp"
 
 // Class Outline ----------------------------------------------------------------------------------------------------------------------------
 
@@ -9,11 +12,35 @@ class Population_Mu1 : public Population<T, L>{
 
 private:
 
-    // Function taking a vector of genes of type T, a child T and a diversity preserver and a diversity preserver
-    std::function<Diversity_Preserver<T>(const std::vector<T>&, const T&, const Diversity_Preserver<T>&, std::mt19937&)>& selectSurvivors_Div;
+    // Function taking the vector of genes of type T, a child T and the diversity preserver, updating genes and diversity preserver in place
+    std::function<void(std::vector<T>&, const T&, Diversity_Preserver<T>&, std::mt19937&)>& selectSurvivors_Div;
     //struct saving the diversity scores of the genes
     Diversity_Preserver<T> div_preserver;
 
+    // Delta path, used instead of selectParents, mutate and selectSurvivors_Div if selectSurvivors_Delta is set:
+    // Function taking a vector of genes of type T and writing the indices of the selected parents into the given vector
+    std::function<void(const std::vector<T>&, const std::vector<L>&, std::vector<int>&, std::mt19937&)> selectParents_Index;
+    // Function taking a vector of genes of type T and writing the mutated genes of type T into the given vector, reporting the delta of each of them
+    std::function<void(const std::vector<T>&, std::vector<T>&, std::vector<Offspring_Delta>&, std::mt19937&)> mutate_Delta;
+    // Function taking the vector of genes of type T, a child T, its delta to its parent and the diversity preserver, updating genes and diversity preserver in place
+    std::function<void(std::vector<T>&, const T&, const Offspring_Delta&, Diversity_Preserver<T>&, std::mt19937&)> selectSurvivors_Delta;
+    // Batch path ((mu+lambda)), used instead of selectSurvivors_Delta if set, one offspring per index written by selectParents_Index:
+    // Function taking the vector of genes of type T, the offspring, their deltas to their parents and the diversity preserver, updating genes and diversity preserver in place
+    std::function<void(std::vector<T>&, const std::vector<T>&, const std::vector<Offspring_Delta>&, Diversity_Preserver<T>&, std::mt19937&)> selectSurvivors_Batch;
+
+    //executes one iteration of the evolutionary algorithm, on the delta path, recording their components as given by recording
+    template <Recording recording> void execute_generation();
+    template <Recording recording> void execute_delta();
+    //executes one generation of the batch path, counting every offspring as a generation (the stored fitness values are invalidated)
+    template <Recording recording> void execute_batch();
+    //parent indices, offspring and their deltas on the delta path, kept to reuse their memory
+    std::vector<int> parent_indices;
+    std::vector<T> offspring;
+    std::vector<Offspring_Delta> deltas;
+    //keeps the stored fitness values in line with the genes after a diversity preserving selection, given the slot index of the offspring
+    //(the selection kept the offspring if it removed another slot), evaluating only the offspring unless the selection handed back its fitness
+    void update_fitnesses(const T& offspring, int index);
+
 public:
 
     // Constructor for population of size size will with genes generated by function initialize
@@ -25,15 +52,25 @@ public:
         std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)>& mutate,
         std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)>& recombine,
         std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const std::vector<T>&, std::mt19937&)>& selectSurvivors,
-        std::function<Diversity_Preserver<T>(const std::vector<T>&, const T&, const Diversity_Preserver<T>&, std::mt19937&)>& selectSurvivors_Div
+        std::function<void(std::vector<T>&, const T&, Diversity_Preserver<T>&, std::mt19937&)>& selectSurvivors_Div
     );
 
     //executes one iteration of the evolutionary algorithm
     void execute() override;  
     using Population<T, L>::execute;
+    //returns the diversity value of the current genes, taken in O(1) from the scores maintained by the diversity preserving survivor selection
+    //(and thus computed with its diversity measure) once it has run, computed by population_diversity before
+    double get_diversity(const std::function<double(const std::vector<T>&)>& population_diversity) override;
+    //additionally writes / restores the diversity preserver (the spare memory is not part of the state)
+    void save(std::ostream& out) override;
+    void load(std::istream& in) override;
 
     // setters of the operator functions
-    void set_selectSurvivors_Div(const std::function<Diversity_Preserver<T>(const std::vector<T>&, const T&, const Diversity_Preserver<T>&, std::mt19937&)>& selectSurvivors_Div);
+    void set_selectSurvivors_Div(const std::function<void(std::vector<T>&, const T&, Diversity_Preserver<T>&, std::mt19937&)>& selectSurvivors_Div);
+    void set_selectParents_Index(const std::function<void(const std::vector<T>&, const std::vector<L>&, std::vector<int>&, std::mt19937&)>& selectParents_Index);
+    void set_mutate_Delta(const std::function<void(const std::vector<T>&, std::vector<T>&, std::vector<Offspring_Delta>&, std::mt19937&)>& mutate_Delta);
+    void set_selectSurvivors_Delta(const std::function<void(std::vector<T>&, const T&, const Offspring_Delta&, Diversity_Preserver<T>&, std::mt19937&)>& selectSurvivors_Delta);
+    void set_selectSurvivors_Batch(const std::function<void(std::vector<T>&, const std::vector<T>&, const std::vector<Offspring_Delta>&, Diversity_Preserver<T>&, std::mt19937&)>& selectSurvivors_Batch);
 };
 
 // Class Implementation ---------------------------------------------------------------------------------------------------------------------
@@ -47,26 +84,148 @@ Population_Mu1<T, L>::Population_Mu1(
     std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)>& mutate,
     std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)>& recombine,
     std::function<std::vector<T>(const std::vector<T>&, const std::vector<L>&, const std::vector<T>&, std::mt19937&)>& selectSurvivors,
-    std::function<Diversity_Preserver<T>(const std::vector<T>&, const T&, const Diversity_Preserver<T>&, std::mt19937&)>& selectSurvivors_Div
+    std::function<void(std::vector<T>&, const T&, Diversity_Preserver<T>&, std::mt19937&)>& selectSurvivors_Div
 ) : Population<T,L>(seed, initialize, evaluate, selectParents, mutate, recombine, selectSurvivors), selectSurvivors_Div(selectSurvivors_Div) {
     assert(selectSurvivors_Div == nullptr || selectSurvivors == nullptr && "selectSurvivors and selectSurvivors_Div cannot be set at the same time");
-    div_preserver = Diversity_Preserver<T>{0, true, std::map<std::tuple<int, int>, double>(), this->genes};
+    div_preserver = initial_diversity_preserver<T>();
 }
 
 template <typename T, typename L>
 void Population_Mu1<T, L>::execute() {
+    Recording recording = this->component_times == nullptr ? Recording::off : this->component_times->recording(this->generation);
+    if(selectSurvivors_Batch != nullptr){
+        if(recording == Recording::timed) execute_batch<Recording::timed>();
+        else if(recording == Recording::counted) execute_batch<Recording::counted>();
+        else execute_batch<Recording::off>();
+        return;
+    }
+    if(selectSurvivors_Delta != nullptr){
+        if(recording == Recording::timed) execute_delta<Recording::timed>();
+        else if(recording == Recording::counted) execute_delta<Recording::counted>();
+        else execute_delta<Recording::off>();
+        return;
+    }
+    if(recording == Recording::timed) execute_generation<Recording::timed>();
+    else if(recording == Recording::counted) execute_generation<Recording::counted>();
+    else execute_generation<Recording::off>();
+}
+
+template <typename T, typename L>
+template <Recording recording>
+void Population_Mu1<T, L>::execute_generation() {
+    Component_Times* times = this->component_times;
     this->generation++;
-    std::vector<L> fitnesses = (this->evaluate == nullptr) ? std::vector<L>(0) : this->evaluate(this->genes);
-    assert(this->evaluate == nullptr || fitnesses.size() == this->genes.size());
-    std::vector<T> parents = (this->selectParents == nullptr) ? this->genes : this->selectParents(this->genes, fitnesses, this->generator);
-    std::vector<T> children = (this->recombine == nullptr) ? parents : this->recombine(parents, this->generator);
-    children = (this->mutate == nullptr) ? children : this->mutate(children, this->generator);
-    this->genes = (this->selectSurvivors == nullptr) ? this->genes : this->selectSurvivors(this->genes, fitnesses, children, this->generator);
+    std::vector<L> no_fitnesses;
+    const std::vector<L>& fitnesses = (this->evaluate == nullptr || !this->consumes_fitness) ? no_fitnesses : record_component<recording>(times, Component::evaluate, [&]() -> const std::vector<L>& { return this->get_fitnesses(this->evaluate); });
+    std::vector<T> parents = (this->selectParents == nullptr) ? this->genes : record_component<recording>(times, Component::selectParents, [&]() { return this->selectParents(this->genes, fitnesses, this->generator); });
+    std::vector<T> children = (this->recombine == nullptr) ? parents : record_component<recording>(times, Component::recombine, [&]() { return this->recombine(parents, this->generator); });
+    children = (this->mutate == nullptr) ? children : record_component<recording>(times, Component::mutate, [&]() { return this->mutate(children, this->generator); });
+    if(this->selectSurvivors != nullptr){
+        this->genes = record_component<recording>(times, Component::selectSurvivors, [&]() { return this->selectSurvivors(this->genes, fitnesses, children, this->generator); });
+        this->fitnesses_valid = false;
+    }
     if(selectSurvivors_Div != nullptr){
-        div_preserver = selectSurvivors_Div(this->genes, children[0], div_preserver, this->generator);
-        this->genes = div_preserver.genes;
+        int index = div_preserver.index;
+        record_component<recording>(times, Component::selectSurvivors, [&]() { selectSurvivors_Div(this->genes, children[0], div_preserver, this->generator); });
+        record_component<recording>(times, Component::evaluate, [&]() { update_fitnesses(children[0], index); });
     }
 }
 
 template <typename T, typename L>
-void Population_Mu1<T, L>::set_selectSurvivors_Div(const std::function<Diversity_Preserver<T>(const std::vector<T>&, const T&, const Diversity_Preserver<T>&, std::mt19937&)>& selectSurvivors_Div){ this->selectSurvivors_Div = selectSurvivors_Div;}
\ No newline at end of file
+template <Recording recording>
+void Population_Mu1<T, L>::execute_delta() {
+    assert(selectParents_Index != nullptr && mutate_Delta != nullptr && "delta path requires selectParents_Index and mutate_Delta");
+    Component_Times* times = this->component_times;
+    this->generation++;
+    std::vector<L> no_fitnesses;
+    const std::vector<L>& fitnesses = (this->evaluate == nullptr || !this->consumes_fitness) ? no_fitnesses : record_component<recording>(times, Component::evaluate, [&]() -> const std::vector<L>& { return this->get_fitnesses(this->evaluate); });
+    record_component<recording>(times, Component::selectParents, [&]() { selectParents_Index(this->genes, fitnesses, parent_indices, this->generator); });
+    assert(parent_indices.size() == 1 && "delta path expects exactly one parent");
+    record_component<recording>(times, Component::mutate, [&]() {
+        offspring.resize(1);
+        offspring[0] = this->genes[parent_indices[0]];
+        mutate_Delta(offspring, offspring, deltas, this->generator);
+    });
+    deltas[0].parent = parent_indices[0];
+    int index = div_preserver.index;
+    record_component<recording>(times, Component::selectSurvivors, [&]() { selectSurvivors_Delta(this->genes, offspring[0], deltas[0], div_preserver, this->generator); });
+    record_component<recording>(times, Component::evaluate, [&]() { update_fitnesses(offspring[0], index); });
+}
+
+template <typename T, typename L>
+template <Recording recording>
+void Population_Mu1<T, L>::execute_batch() {
+    assert(selectParents_Index != nullptr && mutate_Delta != nullptr && "batch path requires selectParents_Index and mutate_Delta");
+    Component_Times* times = this->component_times;
+    std::vector<L> no_fitnesses;
+    const std::vector<L>& fitnesses = (this->evaluate == nullptr || !this->consumes_fitness) ? no_fitnesses : record_component<recording>(times, Component::evaluate, [&]() -> const std::vector<L>& { return this->get_fitnesses(this->evaluate); });
+    record_component<recording>(times, Component::selectParents, [&]() { selectParents_Index(this->genes, fitnesses, parent_indices, this->generator); });
+    record_component<recording>(times, Component::mutate, [&]() {
+        offspring.resize(parent_indices.size());
+        for(int i = 0; i < (int) parent_indices.size(); i++) offspring[i] = this->genes[parent_indices[i]];
+        mutate_Delta(offspring, offspring, deltas, this->generator);
+    });
+    for(int i = 0; i < (int) parent_indices.size(); i++) deltas[i].parent = parent_indices[i];
+    this->generation += offspring.size();
+    record_component<recording>(times, Component::selectSurvivors, [&]() { selectSurvivors_Batch(this->genes, offspring, deltas, div_preserver, this->generator); });
+    this->fitnesses_valid = false;
+}
+
+template <typename T, typename L>
+void Population_Mu1<T, L>::update_fitnesses(const T& offspring, int index) {
+    bool evaluated = div_preserver.offspring_evaluated;
+    div_preserver.offspring_evaluated = false;
+    if(!this->fitnesses_valid || div_preserver.index == index) return;
+    this->fitnesses.insert(this->fitnesses.begin() + index, evaluated ? div_preserver.offspring_fitness : this->evaluate({offspring})[0]);
+    this->fitnesses.erase(this->fitnesses.begin() + div_preserver.index);
+}
+
+template <typename T, typename L>
+double Population_Mu1<T, L>::get_diversity(const std::function<double(const std::vector<T>&)>& population_diversity) {
+    if(div_preserver.first) return Population<T, L>::get_diversity(population_diversity);
+    assert(div_preserver.size == this->genes.size() + 1);
+    int n = std::accumulate(this->genes[0].begin(), this->genes[0].end(), 0, [](int sum, const auto& machine) -> int {
+        return sum + machine.size();
+    });
+    int mu = this->genes.size();
+    return diversity_value(div_preserver.squared_sum - div_preserver.squared_row_sums[div_preserver.index], n, mu);
+}
+
+template <typename T, typename L>
+void Population_Mu1<T, L>::save(std::ostream& out) {
+    Population<T, L>::save(out);
+    write_binary(out, div_preserver.index);
+    write_binary(out, div_preserver.first);
+    write_binary(out, div_preserver.size);
+    write_binary(out, div_preserver.diversity_scores);
+    write_binary(out, div_preserver.encodings);
+    write_binary(out, div_preserver.successors);
+    write_binary(out, div_preserver.schedules);
+    write_binary(out, div_preserver.squared_row_sums);
+    write_binary(out, div_preserver.squared_sum);
+}
+
+template <typename T, typename L>
+void Population_Mu1<T, L>::load(std::istream& in) {
+    Population<T, L>::load(in);
+    read_binary(in, div_preserver.index);
+    read_binary(in, div_preserver.first);
+    read_binary(in, div_preserver.size);
+    read_binary(in, div_preserver.diversity_scores);
+    read_binary(in, div_preserver.encodings);
+    read_binary(in, div_preserver.successors);
+    read_binary(in, div_preserver.schedules);
+    read_binary(in, div_preserver.squared_row_sums);
+    read_binary(in, div_preserver.squared_sum);
+}
+
+template <typename T, typename L>
+void Population_Mu1<T, L>::set_selectSurvivors_Div(const std::function<void(std::vector<T>&, const T&, Diversity_Preserver<T>&, std::mt19937&)>& selectSurvivors_Div){ this->selectSurvivors_Div = selectSurvivors_Div;}
+template <typename T, typename L>
+void Population_Mu1<T, L>::set_selectParents_Index(const std::function<void(const std::vector<T>&, const std::vector<L>&, std::vector<int>&, std::mt19937&)>& selectParents_Index){ this->selectParents_Index = selectParents_Index;}
+template <typename T, typename L>
+void Population_Mu1<T, L>::set_mutate_Delta(const std::function<void(const std::vector<T>&, std::vector<T>&, std::vector<Offspring_Delta>&, std::mt19937&)>& mutate_Delta){ this->mutate_Delta = mutate_Delta;}
+template <typename T, typename L>
+void Population_Mu1<T, L>::set_selectSurvivors_Delta(const std::function<void(std::vector<T>&, const T&, const Offspring_Delta&, Diversity_Preserver<T>&, std::mt19937&)>& selectSurvivors_Delta){ this->selectSurvivors_Delta = selectSurvivors_Delta;}
+template <typename T, typename L>
+void Population_Mu1<T, L>::set_selectSurvivors_Batch(const std::function<void(std::vector<T>&, const std::vector<T>&, const std::vector<Offspring_Delta>&, Diversity_Preserver<T>&, std::mt19937&)>& selectSurvivors_Batch){ this->selectSurvivors_Batch = selectSurvivors_Batch;}
\ No newline at end of file
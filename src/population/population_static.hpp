@@ -0,0 +1,112 @@
+#pragma once
+
+#include <numeric>
+
+#include "population.hpp"
+#include "../operators/operators_diversity.hpp"
+
+// Class Outline ----------------------------------------------------------------------------------------------------------------------------
+
+/*
+    Mu1 population composed at compile time: the operators are policy types instead of std::functions, so they can be inlined into the generation loop
+    Each generation selects a uniformly random parent, mutates a copy of it in place (Mutation: void(G&, Offspring_Delta&, std::mt19937&))
+    and hands the offspring with its delta to the survivor selection (Survivors: void(std::vector<G>&, const G&, const Offspring_Delta&, Diversity_Preserver<G>&, std::mt19937&)),
+    consuming the same random numbers as Population_Mu1 on the delta path
+*/
+template <typename G, typename L, typename Mutation, typename Survivors> // G: type of genes, L: type of fitness values
+class Population_Static{
+
+private:
+
+    std::vector<G> genes;
+    std::mt19937 generator;
+    int generation;
+
+    Mutation mutate;
+    Survivors selectSurvivors;
+    //struct saving the diversity scores of the genes
+    Diversity_Preserver<G> div_preserver;
+    //offspring of the current generation and its delta to the parent, kept to reuse their memory
+    G offspring;
+    Offspring_Delta delta;
+
+public:
+
+    // Constructor for population with genes generated by function initialize
+    Population_Static(int seed, std::function<std::vector<G>(std::mt19937&)> initialize, Mutation mutate, Survivors selectSurvivors);
+
+    //executes one iteration of the evolutionary algorithm
+    void execute();
+    //executes iterations of the evolutionary algorithm until the termination criterion is met
+    template <typename Termination>
+    void execute(const Termination& termination_criterion);
+    //get maximum fitness value over the course of the algorithm
+    L get_best_fitness(std::function<std::vector<L>(const std::vector<G>&)>& evaluate);
+    //returns the current genes in the population
+    std::vector<G> get_genes(bool keep_duplicats);
+    //returns the diversity value of the current genes, taken from the preserved scores once the survivor selection has run
+    double get_diversity(const std::function<double(const std::vector<G>&)>& population_diversity);
+    //returns the number of generation that have been executed
+    int get_generation();
+};
+
+// Class Implementation ---------------------------------------------------------------------------------------------------------------------
+
+template <typename G, typename L, typename Mutation, typename Survivors>
+Population_Static<G, L, Mutation, Survivors>::Population_Static(int seed, std::function<std::vector<G>(std::mt19937&)> initialize, Mutation mutate, Survivors selectSurvivors)
+    : generator(seed), generation(0), mutate(mutate), selectSurvivors(selectSurvivors) {
+    assert(initialize != nullptr && "initialize function must be set");
+    genes = initialize(generator);
+    assert(genes.size() > 0 && "initialize function must return a non-empty vector");
+    div_preserver = initial_diversity_preserver<G>();
+}
+
+template <typename G, typename L, typename Mutation, typename Survivors>
+void Population_Static<G, L, Mutation, Survivors>::execute() {
+    generation++;
+    std::uniform_int_distribution< int > distribute_point(0, genes.size() - 1 );
+    delta.parent = distribute_point(generator);
+    delta.changes.clear();
+    delta.machines.clear();
+    offspring = genes[delta.parent];
+    mutate(offspring, delta, generator);
+    selectSurvivors(genes, offspring, delta, div_preserver, generator);
+}
+
+template <typename G, typename L, typename Mutation, typename Survivors>
+template <typename Termination>
+void Population_Static<G, L, Mutation, Survivors>::execute(const Termination& termination_criterion) {
+    while(!termination_criterion(*this)){
+        execute();
+    }
+}
+
+template <typename G, typename L, typename Mutation, typename Survivors>
+L Population_Static<G, L, Mutation, Survivors>::get_best_fitness(std::function<std::vector<L>(const std::vector<G>&)>& evaluate){
+    std::vector<L> fitnesses = evaluate(genes);
+    return *std::min_element(fitnesses.begin(), fitnesses.end());
+}
+
+template <typename G, typename L, typename Mutation, typename Survivors>
+std::vector<G> Population_Static<G, L, Mutation, Survivors>::get_genes(bool keep_duplicats){
+    if(keep_duplicats) return genes;
+    std::vector<G> genes_copy = genes;
+    std::sort(genes_copy.begin(), genes_copy.end());
+    genes_copy.erase(std::unique(genes_copy.begin(), genes_copy.end()), genes_copy.end());
+    return genes_copy;
+}
+
+template <typename G, typename L, typename Mutation, typename Survivors>
+double Population_Static<G, L, Mutation, Survivors>::get_diversity(const std::function<double(const std::vector<G>&)>& population_diversity) {
+    if(div_preserver.first) return population_diversity(genes);
+    int n = std::accumulate(genes[0].begin(), genes[0].end(), 0, [](int sum, const auto& machine) -> int {
+        return sum + machine.size();
+    });
+    int mu = genes.size();
+    return diversity_value(div_preserver.squared_sum - div_preserver.squared_row_sums[div_preserver.index], n, mu);
+}
+
+template <typename G, typename L, typename Mutation, typename Survivors>
+int Population_Static<G, L, Mutation, Survivors>::get_generation(){
+    return generation;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <istream>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+
+#include "gene_pool.hpp"
+
+/*
+    Binary serialization of population states (see Population::save / Population::load)
+    Arithmetic values are stored in their native representation, so checkpoints are only read back on the machine type that wrote them
+*/
+
+template <typename V>
+std::enable_if_t<std::is_arithmetic_v<V>> write_binary(std::ostream& out, const V& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(V));
+}
+
+template <typename V>
+std::enable_if_t<std::is_arithmetic_v<V>> read_binary(std::istream& in, V& value) {
+    if(!in.read(reinterpret_cast<char*>(&value), sizeof(V))) throw std::runtime_error("Truncated checkpoint.");
+}
+
+template <typename V, typename Allocator>
+void write_binary(std::ostream& out, const std::vector<V, Allocator>& values) {
+    write_binary(out, (unsigned long long) values.size());
+    for(const V& value : values) write_binary(out, value);
+}
+
+template <typename V, typename Allocator>
+void read_binary(std::istream& in, std::vector<V, Allocator>& values) {
+    unsigned long long size;
+    read_binary(in, size);
+    values.resize(size);
+    for(V& value : values) read_binary(in, value);
+}
+
+void write_binary(std::ostream& out, const std::mt19937& generator) {
+    std::ostringstream state;
+    state << generator;
+    std::string characters = state.str();
+    write_binary(out, std::vector<char>(characters.begin(), characters.end()));
+}
+
+void read_binary(std::istream& in, std::mt19937& generator) {
+    std::vector<char> characters;
+    read_binary(in, characters);
+    std::istringstream state(std::string(characters.begin(), characters.end()));
+    if(!(state >> generator)) throw std::runtime_error("Invalid generator state in checkpoint.");
+}
+
+// Genes are stored machine by machine, so every gene layout reads the checkpoints of every other one
+template <typename G>
+void write_gene(std::ostream& out, const G& gene) {
+    write_binary(out, (unsigned long long) gene.size());
+    for(const auto& machine : gene){
+        write_binary(out, (unsigned long long) machine.size());
+        for(int job : machine) write_binary(out, job);
+    }
+}
+
+template <typename G>
+void read_gene(std::istream& in, G& gene) {
+    std::vector<std::vector<int>> nested_gene;
+    read_binary(in, nested_gene);
+    gene = make_gene<G>(nested_gene);
+}
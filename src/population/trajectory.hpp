@@ -0,0 +1,145 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#include "../utility/result_sink.hpp"
+
+// Sampling of the generations recorded by Trajectory_Recorder: every interval-th generation, log-spaced generations (each about factor times the last) or generations changing diversity or best fitness
+struct Trajectory_Sampling {
+    enum class Mode { every, logarithmic, change };
+    Mode mode = Mode::every;
+    int interval = 1;
+    double factor = 1.1;
+};
+
+// Parses "every:<interval>", "log:<factor>" or "change"
+Trajectory_Sampling parse_trajectory_sampling(std::string value) {
+    Trajectory_Sampling sampling;
+    if(value == "change"){
+        sampling.mode = Trajectory_Sampling::Mode::change;
+    }else if(value.rfind("every:", 0) == 0){
+        sampling.mode = Trajectory_Sampling::Mode::every;
+        sampling.interval = std::stoi(value.substr(6));
+        if(sampling.interval < 1) throw std::invalid_argument("Invalid trajectory interval.");
+    }else if(value.rfind("log:", 0) == 0){
+        sampling.mode = Trajectory_Sampling::Mode::logarithmic;
+        sampling.factor = std::stod(value.substr(4));
+        if(!(sampling.factor > 1)) throw std::invalid_argument("Invalid trajectory factor, pass a factor > 1.");
+    }else{
+        throw std::invalid_argument("Invalid trajectory sampling, pass every:<interval>, log:<factor> or change.");
+    }
+    return sampling;
+}
+
+// Run a trajectory belongs to, written in front of every block of it (alpha is NaN for unconstrained runs)
+struct Trajectory_Run {
+    int seed, n, m, mu, run;
+    double alpha = std::numeric_limits<double>::quiet_NaN();
+    std::string algorithm, mutation;
+};
+
+/*
+    Records (generation, diversity, best fitness, unique genes) of the sampled generations of a run into a buffer of capacity points,
+    which is appended to sink as one block whenever it is full and on flush (called by terminate_recording after the last generation)
+    Block layout (native byte order), blocks of concurrent runs interleave in the file:
+        - magic (16 bytes), seed, n, m, mu, run (int32 each), alpha (double)
+        - length (uint32) and characters of algorithm and of mutation, number of points (uint32)
+        - columns of the points: generations (int32), diversities (double), best fitnesses (double), unique genes (int32)
+    Converted to csv by experiments/scripts_analysis/ConvertTrajectory.py
+*/
+class Trajectory_Recorder {
+
+public:
+
+    static constexpr char magic[16] = "EDO-TRAJECTORY1";
+
+    Trajectory_Recorder(Result_Sink& sink, Trajectory_Run run, Trajectory_Sampling sampling, int capacity = 4096) : sink(sink), run(run), sampling(sampling), capacity(capacity) {
+        generations.reserve(capacity);
+        diversities.reserve(capacity);
+        fitnesses.reserve(capacity);
+        uniques.reserve(capacity);
+    }
+
+    ~Trajectory_Recorder() { flush(); }
+
+    Trajectory_Recorder(const Trajectory_Recorder&) = delete;
+    Trajectory_Recorder& operator=(const Trajectory_Recorder&) = delete;
+
+    const Trajectory_Sampling& get_sampling() const { return sampling; }
+
+    // whether generation is sampled by Mode::every or Mode::logarithmic (generations are passed in increasing order)
+    bool sampled(int generation) {
+        if(sampling.mode == Trajectory_Sampling::Mode::every) return generation % sampling.interval == 0;
+        if(sampling.mode == Trajectory_Sampling::Mode::change || generation < next_generation) return false;
+        next_generation = std::max<double>(generation + 1, std::ceil(generation * sampling.factor));
+        return true;
+    }
+
+    // whether diversity or best_fitness differ from the last recorded point (Mode::change)
+    bool changed(double diversity, double best_fitness) const {
+        return !recorded || diversity != last_diversity || best_fitness != last_fitness;
+    }
+
+    void record(int generation, double diversity, double best_fitness, int unique) {
+        generations.push_back(generation);
+        diversities.push_back(diversity);
+        fitnesses.push_back(best_fitness);
+        uniques.push_back(unique);
+        last_diversity = diversity;
+        last_fitness = best_fitness;
+        recorded = true;
+        if((int) generations.size() >= capacity) flush();
+    }
+
+    // appends the buffered points to the sink as one block
+    void flush() {
+        if(generations.empty()) return;
+        std::string block(magic, sizeof(magic));
+        for(int32_t value : {run.seed, run.n, run.m, run.mu, run.run}) append(block, value);
+        append(block, run.alpha);
+        for(const std::string& text : {run.algorithm, run.mutation}){
+            append(block, (uint32_t) text.size());
+            block += text;
+        }
+        append(block, (uint32_t) generations.size());
+        append_column(block, generations);
+        append_column(block, diversities);
+        append_column(block, fitnesses);
+        append_column(block, uniques);
+        sink.write(std::move(block));
+        generations.clear();
+        diversities.clear();
+        fitnesses.clear();
+        uniques.clear();
+    }
+
+private:
+
+    Result_Sink& sink;
+    Trajectory_Run run;
+    Trajectory_Sampling sampling;
+    int capacity;
+    std::vector<int32_t> generations;
+    std::vector<double> diversities;
+    std::vector<double> fitnesses;
+    std::vector<int32_t> uniques;
+    int next_generation = 0;
+    bool recorded = false;
+    double last_diversity = 0, last_fitness = 0;
+
+    template <typename V>
+    static void append(std::string& block, V value) {
+        block.append(reinterpret_cast<const char*>(&value), sizeof(V));
+    }
+
+    template <typename V>
+    static void append_column(std::string& block, const std::vector<V>& column) {
+        block.append(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(V));
+    }
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <chrono>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+
+#include "performance_counters.hpp"
+
+// Benchmarking ------------------------------------------------------------------------
+
+// Timing of one benchmark on one fixture (mu, n, m), times per call of the operation in nanoseconds over the repetitions
+struct Benchmark_Result {
+    std::string benchmark;
+    int mu, n, m;
+    long long iterations;   // calls of the operation per repetition
+    double median_ns, min_ns, max_ns;
+    std::vector<double> counters;   // performance counters per call over the repetitions (see Performance_Counters), empty if not recorded
+};
+
+/*
+    Times operation: calibrates the number of calls so that a repetition takes about min_time / repetitions seconds,
+    then runs the repetitions and reports the median, minimum and maximum time per call (and the performance counters per call, if performance_counters is set)
+    The operation returns a checksum, which is accumulated so the compiler cannot drop the work
+*/
+Benchmark_Result run_benchmark(std::string benchmark, int mu, int n, int m, std::function<double()> operation, int repetitions, double min_time, bool performance_counters = false) {
+    static volatile double checksum = 0;
+    using Clock = std::chrono::steady_clock;
+    double repetition_time = min_time / repetitions;
+
+    long long iterations = 1;
+    while(true){
+        Clock::time_point start = Clock::now();
+        for(long long i = 0; i < iterations; i++) checksum = checksum + operation();
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        if(elapsed >= repetition_time / 4 || iterations >= (1LL << 40)){
+            if(elapsed > 0) iterations = std::max(1LL, (long long) (iterations * repetition_time / elapsed));
+            break;
+        }
+        iterations *= 4;
+    }
+
+    std::unique_ptr<Performance_Counters> counters = performance_counters ? std::make_unique<Performance_Counters>() : nullptr;
+    if(counters != nullptr) counters->start();
+    std::vector<double> times;
+    for(int repetition = 0; repetition < repetitions; repetition++){
+        Clock::time_point start = Clock::now();
+        for(long long i = 0; i < iterations; i++) checksum = checksum + operation();
+        times.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations);
+    }
+    std::vector<double> counters_per_call;
+    if(counters != nullptr){
+        counters->stop();
+        for(long long value : counters->read()) counters_per_call.push_back(value < 0 ? -1 : (double) value / (iterations * repetitions));
+    }
+    std::sort(times.begin(), times.end());
+    double median = times.size() % 2 == 1 ? times[times.size() / 2] : (times[times.size() / 2 - 1] + times[times.size() / 2]) / 2;
+    return {benchmark, mu, n, m, iterations, median, times.front(), times.back(), counters_per_call};
+}
+
+std::string get_benchmark_csv(const std::vector<Benchmark_Result>& results) {
+    std::ostringstream csv;
+    bool counters = !results.empty() && !results.front().counters.empty();
+    csv << "benchmark,mu,n,m,iterations,median_ns,min_ns,max_ns" << (counters ? get_performance_counters_header() : "") << "\n";
+    csv << std::fixed << std::setprecision(1);
+    for(const Benchmark_Result& result : results){
+        csv << result.benchmark << "," << result.mu << "," << result.n << "," << result.m << "," << result.iterations << ","
+            << result.median_ns << "," << result.min_ns << "," << result.max_ns;
+        for(double value : result.counters) csv << "," << value;
+        csv << "\n";
+    }
+    return csv.str();
+}
+
+std::string get_benchmark_json(const std::vector<Benchmark_Result>& results) {
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(1) << "[\n";
+    for(size_t i = 0; i < results.size(); i++){
+        const Benchmark_Result& result = results[i];
+        json << "    {\"benchmark\": \"" << result.benchmark << "\", \"mu\": " << result.mu << ", \"n\": " << result.n << ", \"m\": " << result.m
+             << ", \"iterations\": " << result.iterations << ", \"median_ns\": " << result.median_ns << ", \"min_ns\": " << result.min_ns
+             << ", \"max_ns\": " << result.max_ns;
+        for(size_t j = 0; j < result.counters.size(); j++) json << ", \"" << Performance_Counters::names[j] << "\": " << result.counters[j];
+        json << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    json << "]\n";
+    return json.str();
+}
+
+// Reads results written by get_benchmark_csv (ignoring performance counters)
+std::vector<Benchmark_Result> read_benchmark_csv(std::string file) {
+    std::ifstream input(file);
+    if(!input.is_open()) throw std::runtime_error("Error opening benchmark baseline: " + file);
+    std::vector<Benchmark_Result> results;
+    std::string line;
+    std::getline(input, line);
+    while(std::getline(input, line)){
+        if(line.empty()) continue;
+        std::vector<std::string> columns;
+        std::istringstream columns_stream(line);
+        std::string column;
+        while(std::getline(columns_stream, column, ',')) columns.push_back(column);
+        if(columns.size() < 8) throw std::runtime_error("Invalid line in benchmark baseline: " + line);
+        results.push_back({columns[0], std::stoi(columns[1]), std::stoi(columns[2]), std::stoi(columns[3]), std::stoll(columns[4]),
+                           std::stod(columns[5]), std::stod(columns[6]), std::stod(columns[7]), {}});
+    }
+    return results;
+}
+
+/*
+    Compares the median times of results with those of baseline, printing one line per benchmark to out
+    Returns whether no benchmark is slower than its baseline by more than the factor 1 + tolerance (benchmarks missing in baseline are only listed)
+*/
+bool compare_benchmarks(const std::vector<Benchmark_Result>& results, const std::vector<Benchmark_Result>& baseline, double tolerance, std::ostream& out) {
+    std::map<std::tuple<std::string, int, int, int>, double> baseline_medians;
+    for(const Benchmark_Result& result : baseline) baseline_medians[{result.benchmark, result.mu, result.n, result.m}] = result.median_ns;
+    int regressions = 0;
+    out << std::fixed << std::setprecision(1);
+    for(const Benchmark_Result& result : results){
+        out << std::left << std::setw(40) << result.benchmark << " mu=" << std::setw(4) << result.mu << " n=" << std::setw(4) << result.n << " m=" << std::setw(3) << result.m;
+        auto entry = baseline_medians.find({result.benchmark, result.mu, result.n, result.m});
+        if(entry == baseline_medians.end()){
+            out << std::right << std::setw(14) << result.median_ns << " ns   (not in baseline)\n";
+            continue;
+        }
+        double ratio = result.median_ns / entry->second;
+        bool regression = ratio > 1 + tolerance;
+        regressions += regression;
+        out << std::right << std::setw(14) << result.median_ns << " ns vs " << std::setw(14) << entry->second << " ns  x" << std::setprecision(3) << ratio
+            << std::setprecision(1) << (regression ? "  REGRESSION" : "") << "\n";
+    }
+    out << regressions << " regressions (tolerance " << tolerance * 100 << "%)" << std::endl;
+    return regressions == 0;
+}
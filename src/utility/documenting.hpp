@@ -9,25 +9,6 @@
 
 using L = double;
 
-void write_to_file(std::string content, std::string filename, bool append = true) {
-    #pragma omp critical
-    {
-        std::ofstream file;
-        if (append) {
-            file.open(filename, std::ios_base::out | std::ios_base::app);
-        } else {
-            file.open(filename, std::ios_base::out | std::ios_base::trunc);
-        }
-
-        if (!file.is_open()) {
-            std::cerr << "Error opening file: " << filename << std::endl;
-        }else{
-            file << content;
-            file.close();
-        }        
-    }
-}
-
 std::string createPopulationReport(
     Population<T,L>& population,
     std::function<std::vector<L>(const std::vector<T>&)> evaluate,
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <tuple>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "generating.hpp"
+
+using T = std::vector<std::vector<int>>;
+
+// Algorithm computing the reference schedule of an instance
+enum class Reference_Solver : int32_t { moore, approximation, exact };
+
+/*
+    Problem instance of a run together with its reference schedule (Moore-Hodgson for m = 1, the approximation algorithm or the exact algorithm otherwise),
+    the fitness OPT of it and a lower bound on the optimal fitness (equal to OPT if the reference schedule is optimal),
+    with the solver of the reference schedule and its time limit in seconds (0 unless solver is exact)
+*/
+struct Instance {
+    int seed, n, max_processing_time, m;
+    MachineSchedulingProblem problem;
+    int OPT;
+    T optimal_solution;
+    int OPT_lower_bound;
+    Reference_Solver solver;
+    double time_limit;
+};
+
+/*
+    Instance cache: read only, memory mapped file of instances, looked up by (seed, n, max_processing_time, m)
+    Layout (native byte order):
+        - magic (16 bytes), number of entries (uint64)
+        - entries sorted by key: seed, n, max_processing_time, m, OPT, OPT_lower_bound, solver, reserved (int32 each), time limit (double),
+          offset of the data of the instance (uint64)
+        - data of every instance (int32): n processing times, n due dates, m machine sizes, the n jobs of the reference schedule machine by machine
+    Built by write_instance_cache, shared by all runs of a process (and, through the page cache, by all processes on a node)
+*/
+class Instance_Cache {
+
+public:
+
+    Instance_Cache() = default;
+
+    ~Instance_Cache() { close(); }
+
+    Instance_Cache(const Instance_Cache&) = delete;
+    Instance_Cache& operator=(const Instance_Cache&) = delete;
+
+    // Maps the cache file path, replacing a previously opened one
+    void open(const std::string& path) {
+        close();
+        int file = ::open(path.c_str(), O_RDONLY);
+        if(file < 0) throw std::runtime_error("Error opening instance cache: " + path);
+        struct stat status;
+        if(::fstat(file, &status) != 0 || status.st_size < (off_t) header_size){
+            ::close(file);
+            throw std::runtime_error("Invalid instance cache: " + path);
+        }
+        size = status.st_size;
+        void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0);
+        ::close(file);
+        if(mapping == MAP_FAILED) throw std::runtime_error("Error mapping instance cache: " + path);
+        data = static_cast<const char*>(mapping);
+        std::memcpy(&count, data + sizeof(magic), sizeof(count));
+        if(std::memcmp(data, magic, sizeof(magic)) != 0 || header_size + count * sizeof(Entry) > size){
+            close();
+            throw std::runtime_error("Invalid instance cache: " + path);
+        }
+    }
+
+    bool is_open() const { return data != nullptr; }
+
+    // Looks up the instance of the key, returns whether the cache contains it
+    bool lookup(int seed, int n, int max_processing_time, int m, Instance& instance) const {
+        if(!is_open()) return false;
+        const Entry* first = entries();
+        const Entry* last = first + count;
+        Entry key{seed, n, max_processing_time, m, 0, 0, 0, 0, 0, 0};
+        const Entry* entry = std::lower_bound(first, last, key, entry_less);
+        if(entry == last || entry_less(key, *entry)) return false;
+        read(*entry, instance);
+        return true;
+    }
+
+    // All instances of the cache
+    std::vector<Instance> instances() const {
+        std::vector<Instance> all(count);
+        for(size_t i = 0; i < count; i++) read(entries()[i], all[i]);
+        return all;
+    }
+
+    // Cache of the process, opened by main
+    static Instance_Cache& shared() {
+        static Instance_Cache cache;
+        return cache;
+    }
+
+private:
+
+    struct Entry {
+        int32_t seed, n, max_processing_time, m, OPT, OPT_lower_bound, solver, reserved;
+        double time_limit;
+        uint64_t offset;
+    };
+
+    static constexpr char magic[16] = "EDO-INSTANCES-4";
+    static constexpr size_t header_size = sizeof(magic) + sizeof(uint64_t);
+
+    const char* data = nullptr;
+    size_t size = 0;
+    uint64_t count = 0;
+
+    static bool entry_less(const Entry& entry1, const Entry& entry2) {
+        return std::tie(entry1.seed, entry1.n, entry1.max_processing_time, entry1.m) < std::tie(entry2.seed, entry2.n, entry2.max_processing_time, entry2.m);
+    }
+
+    const Entry* entries() const { return reinterpret_cast<const Entry*>(data + header_size); }
+
+    void read(const Entry& entry, Instance& instance) const {
+        size_t values = 3 * size_t(entry.n) + entry.m;
+        if(entry.offset + values * sizeof(int32_t) > size) throw std::runtime_error("Invalid instance cache entry.");
+        const int32_t* values_data = reinterpret_cast<const int32_t*>(data + entry.offset);
+        instance.seed = entry.seed;
+        instance.n = entry.n;
+        instance.max_processing_time = entry.max_processing_time;
+        instance.m = entry.m;
+        instance.OPT = entry.OPT;
+        instance.OPT_lower_bound = entry.OPT_lower_bound;
+        instance.solver = static_cast<Reference_Solver>(entry.solver);
+        instance.time_limit = entry.time_limit;
+        instance.problem.processing_times.assign(values_data, values_data + entry.n);
+        instance.problem.due_dates.assign(values_data + entry.n, values_data + 2 * entry.n);
+        const int32_t* machine_sizes = values_data + 2 * entry.n;
+        const int32_t* jobs = machine_sizes + entry.m;
+        instance.optimal_solution.assign(entry.m, {});
+        for(int i = 0; i < entry.m; i++){
+            instance.optimal_solution[i].assign(jobs, jobs + machine_sizes[i]);
+            jobs += machine_sizes[i];
+        }
+    }
+
+    void close() {
+        if(data != nullptr) ::munmap(const_cast<char*>(data), size);
+        data = nullptr;
+        size = 0;
+        count = 0;
+    }
+
+    friend void write_instance_cache(const std::string& path, std::vector<Instance> instances);
+};
+
+// Writes instances to the cache file path (replacing it atomically, the instances are sorted by key)
+void write_instance_cache(const std::string& path, std::vector<Instance> instances) {
+    using Entry = Instance_Cache::Entry;
+    std::sort(instances.begin(), instances.end(), [](const Instance& instance1, const Instance& instance2) {
+        return std::tie(instance1.seed, instance1.n, instance1.max_processing_time, instance1.m) < std::tie(instance2.seed, instance2.n, instance2.max_processing_time, instance2.m);
+    });
+    std::vector<Entry> entries;
+    std::vector<int32_t> values;
+    uint64_t offset = Instance_Cache::header_size + instances.size() * sizeof(Entry);
+    for(const Instance& instance : instances){
+        entries.push_back({instance.seed, instance.n, instance.max_processing_time, instance.m, instance.OPT, instance.OPT_lower_bound, static_cast<int32_t>(instance.solver), 0, instance.time_limit, offset + values.size() * sizeof(int32_t)});
+        values.insert(values.end(), instance.problem.processing_times.begin(), instance.problem.processing_times.end());
+        values.insert(values.end(), instance.problem.due_dates.begin(), instance.problem.due_dates.end());
+        for(const auto& machine : instance.optimal_solution) values.push_back(machine.size());
+        for(const auto& machine : instance.optimal_solution) values.insert(values.end(), machine.begin(), machine.end());
+    }
+    uint64_t count = entries.size();
+
+    std::string temporary_path = path + ".tmp";
+    {
+        std::ofstream file(temporary_path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+        if(!file.is_open()) throw std::runtime_error("Error opening instance cache: " + temporary_path);
+        file.write(Instance_Cache::magic, sizeof(Instance_Cache::magic));
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+        file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(int32_t));
+        if(!file) throw std::runtime_error("Error writing instance cache: " + temporary_path);
+    }
+    if(std::rename(temporary_path.c_str(), path.c_str()) != 0) throw std::runtime_error("Error replacing instance cache: " + path);
+}
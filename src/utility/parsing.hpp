@@ -6,6 +6,7 @@
 #include <stdexcept>
 
 #include "../operators/operators_mutation.hpp"
+#include "../population/trajectory.hpp"
 
 template <typename list_type>
 std::vector<list_type> parse_list(std::string input){
@@ -26,25 +27,128 @@ std::vector<list_type> parse_list(std::string input){
 
 using T = std::vector<std::vector<int>>;
 
-std::tuple<std::string, std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)>, std::string, std::vector<int>, std::vector<int>, std::vector<int>, std::vector<double>, int, std::string> parse_arguments(int argc, char **argv){
-    if(argc != 10){
+/*
+    Optional arguments, passed as --name=value after the positional ones
+        - genes: gene layout used by the algorithms, {"nested", "flat"}
+        - engine: population used by the Mu1 algorithms, {"dynamic", "static"} (operators as std::functions or composed at compile time)
+        - allocator: memory of the genes, {"default", "pool"} (heap or a gene pool per run, see gene_pool.hpp)
+        - resume: continue an interrupted experiment from its output file and population checkpoints, {"no", "yes"}
+        - shard-index, shard-count: only run part shard-index (0 to shard-count - 1) of shard-count cost balanced parts of the grid
+        - instances: instance cache file to take the problem instances and reference schedules from (see instance_cache.hpp)
+        - build-instances: instead of running the experiment, add the instances of its grid to this instance cache file
+        - component-times: record the time and calls per component of the generations, written as additional csv columns, {"no", "yes"}
+        - perf-counters: record the performance counters (perf_event_open) of every run, written as additional csv columns, {"no", "yes"}
+        - offspring, offspring-selection: offspring per generation of the Mu1 algorithms and their selection, {"sequential", "greedy"}
+        - diversity: computation of the DFM scores of the Mu1 offspring, {"successor", "bitset-dense", "bitset-sliced"} (successor tables or edge bitsets)
+        - exact-opt: time limit in seconds of the exact algorithm computing OPT for m > 1 per instance, 0 for the approximation algorithm
+*/
+struct Options {
+    std::string genes = "nested";
+    std::string engine = "dynamic";
+    std::string allocator = "default";
+    bool resume = false;
+    int shard_index = 0;
+    int shard_count = 1;
+    std::string instances = "";
+    std::string build_instances = "";
+    double exact_time_limit = 0;
+    bool component_times = false;
+    bool performance_counters = false;
+    std::string trajectory = "";
+    int offspring = 1;
+    bool greedy_selection = false;
+    std::string diversity = "successor";
+};
+
+Options parse_options(int argc, char **argv){
+    if(argc < 10){
         throw std::invalid_argument("Pass 9 arguments. You only passed "+ std::to_string(argc - 1) + ". (Pass '-' for unused parameters)");
     }
+    Options options;
+    for(int i = 10; i < argc; i++){
+        std::string argument(argv[i]);
+        size_t separator = argument.find('=');
+        if(argument.rfind("--", 0) != 0 || separator == std::string::npos){
+            throw std::invalid_argument("Invalid option '" + argument + "'. Use --name=value.");
+        }
+        std::string name = argument.substr(2, separator - 2);
+        std::string value = argument.substr(separator + 1);
+        if(name == "genes"){
+            if(value != "nested" && value != "flat") throw std::invalid_argument("Invalid gene layout.");
+            options.genes = value;
+        }else if(name == "engine"){
+            if(value != "dynamic" && value != "static") throw std::invalid_argument("Invalid engine.");
+            options.engine = value;
+        }else if(name == "allocator"){
+            if(value != "default" && value != "pool") throw std::invalid_argument("Invalid allocator.");
+            options.allocator = value;
+        }else if(name == "resume"){
+            if(value != "no" && value != "yes") throw std::invalid_argument("Invalid resume value.");
+            options.resume = value == "yes";
+        }else if(name == "shard-index"){
+            options.shard_index = std::stoi(value);
+        }else if(name == "shard-count"){
+            options.shard_count = std::stoi(value);
+        }else if(name == "instances"){
+            options.instances = value;
+        }else if(name == "build-instances"){
+            options.build_instances = value;
+        }else if(name == "component-times"){
+            if(value != "no" && value != "yes") throw std::invalid_argument("Invalid component-times value.");
+            options.component_times = value == "yes";
+        }else if(name == "perf-counters"){
+            if(value != "no" && value != "yes") throw std::invalid_argument("Invalid perf-counters value.");
+            options.performance_counters = value == "yes";
+        }else if(name == "trajectory"){
+            parse_trajectory_sampling(value);
+            options.trajectory = value;
+        }else if(name == "offspring"){
+            options.offspring = std::stoi(value);
+            if(options.offspring < 1) throw std::invalid_argument("Invalid number of offspring.");
+        }else if(name == "offspring-selection"){
+            if(value != "greedy" && value != "sequential") throw std::invalid_argument("Invalid offspring-selection value.");
+            options.greedy_selection = value == "greedy";
+        }else if(name == "diversity"){
+            if(value != "successor" && value != "bitset-dense" && value != "bitset-sliced") throw std::invalid_argument("Invalid diversity value.");
+            options.diversity = value;
+        }else if(name == "exact-opt"){
+            options.exact_time_limit = std::stod(value);
+            if(options.exact_time_limit < 0) throw std::invalid_argument("Invalid time limit of the exact algorithm.");
+        }else{
+            throw std::invalid_argument("Unknown option '" + name + "'.");
+        }
+    }
+    if(options.shard_count < 1 || options.shard_index < 0 || options.shard_index >= options.shard_count){
+        throw std::invalid_argument("Invalid shard, pass 0 <= shard-index < shard-count.");
+    }
+    if(options.diversity != "successor" && options.offspring > 1){
+        throw std::invalid_argument("The bitset diversity is only available with one offspring per generation.");
+    }
+    return options;
+}
+
+template <typename G = T>
+std::tuple<std::string, std::function<std::vector<G>(const std::vector<G>&, std::mt19937&)>, std::function<void(const std::vector<G>&, std::vector<G>&, std::vector<Offspring_Delta>&, std::mt19937&)>, std::string, std::vector<int>, std::vector<int>, std::vector<int>, std::vector<double>, int, std::string> parse_arguments(int argc, char **argv){
+    parse_options(argc, argv);
 
     std::string experiment_type(argv[1]);    
-    std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> mutation_operator;
+    std::function<std::vector<G>(const std::vector<G>&, std::mt19937&)> mutation_operator;
+    std::function<void(const std::vector<G>&, std::vector<G>&, std::vector<Offspring_Delta>&, std::mt19937&)> mutation_operator_delta;
     double lambda = 0.0;
     if(std::string(argv[2]) == "XRAI"){
         lambda = std::stod(argv[9]);
     }
     std::string mutation_operator_name(argv[2]);
     if(mutation_operator_name == "1RAI"){
-        mutation_operator = mutate_removeinsert(1);
+        mutation_operator = mutate_removeinsert<G>(1);
+        mutation_operator_delta = mutate_removeinsert_delta<G>(1);
     }else if(mutation_operator_name == "XRAI"){
         mutation_operator_name += "_" + std::to_string(lambda);
-        mutation_operator = mutate_xremoveinsert(1, lambda);
+        mutation_operator = mutate_xremoveinsert<G>(1, lambda);
+        mutation_operator_delta = mutate_xremoveinsert_delta<G>(1, lambda);
     }else if(mutation_operator_name == "NSWAP"){
-        mutation_operator = mutate_neighborswap(1);
+        mutation_operator = mutate_neighborswap<G>(1);
+        mutation_operator_delta = mutate_neighborswap_delta<G>(1);
     }else{
         throw std::invalid_argument("Invalid mutation operator.");
     }
@@ -56,5 +160,5 @@ std::tuple<std::string, std::function<std::vector<T>(const std::vector<T>&, std:
     std::vector<double> alphas = parse_list<double>(argv[8]);
     
 
-    return std::make_tuple(experiment_type, mutation_operator, output_file, mus, ns, ms, alphas, runs, mutation_operator_name);
+    return std::make_tuple(experiment_type, mutation_operator, mutation_operator_delta, output_file, mus, ns, ms, alphas, runs, mutation_operator_name);
 }
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+/*
+    Performance counters of the calling thread (Linux perf_event_open, user space only): cycles, instructions, cache misses, branch misses and page faults
+    The counters follow the thread that constructed them, so every run of the OpenMP experiment loop creates its own
+    Counters that cannot be opened (e.g. hardware counters in virtual machines, or perf_event_paranoid too high) read as -1,
+    counters the kernel multiplexed are scaled to the whole time they were enabled
+*/
+class Performance_Counters {
+
+public:
+
+    static constexpr int counters = 5;
+    static constexpr const char* names[counters] = {"cycles", "instructions", "cache_misses", "branch_misses", "page_faults"};
+
+    Performance_Counters() {
+        const std::array<std::pair<uint32_t, uint64_t>, counters> events = {{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS}
+        }};
+        for(int i = 0; i < counters; i++){
+            perf_event_attr attributes;
+            std::memset(&attributes, 0, sizeof(attributes));
+            attributes.size = sizeof(attributes);
+            attributes.type = events[i].first;
+            attributes.config = events[i].second;
+            attributes.disabled = 1;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            files[i] = syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+        }
+    }
+
+    ~Performance_Counters() {
+        for(int file : files) if(file >= 0) close(file);
+    }
+
+    Performance_Counters(const Performance_Counters&) = delete;
+    Performance_Counters& operator=(const Performance_Counters&) = delete;
+
+    // resets the counters and starts counting
+    void start() {
+        for(int file : files){
+            if(file < 0) continue;
+            ioctl(file, PERF_EVENT_IOC_RESET, 0);
+            ioctl(file, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    void stop() {
+        for(int file : files) if(file >= 0) ioctl(file, PERF_EVENT_IOC_DISABLE, 0);
+    }
+
+    // values counted between start and stop, in the order of names (-1: not available)
+    std::array<long long, counters> read() const {
+        std::array<long long, counters> values;
+        for(int i = 0; i < counters; i++){
+            uint64_t data[3];    // value, time enabled, time running
+            if(files[i] < 0 || ::read(files[i], data, sizeof(data)) != sizeof(data)){
+                values[i] = -1;
+                continue;
+            }
+            values[i] = data[2] == 0 ? 0 : (long long) ((double) data[0] * data[1] / data[2]);
+        }
+        return values;
+    }
+
+private:
+
+    std::array<int, counters> files;
+};
+
+// csv columns of Performance_Counters, ",<counter>" per counter
+std::string get_performance_counters_header() {
+    std::string header;
+    for(const char* name : Performance_Counters::names) header += std::string(",") + name;
+    return header;
+}
+
+std::string get_performance_counters_columns(const Performance_Counters& performance_counters) {
+    std::string columns;
+    for(long long value : performance_counters.read()) columns += "," + std::to_string(value);
+    return columns;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <string>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <iostream>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+/*
+    Result sink: collects the results of concurrently running experiments and appends them to one output file
+    write is lock free (results are pushed onto an atomic list), a single writer thread drains the list and appends everything pending in one write call,
+    checkpoint blocks until all results written so far are on disk (fsync), the destructor writes the remaining results and closes the file
+    Arguments:
+        - filename: output file
+        - append: keep the content of the file (otherwise it is truncated)
+*/
+class Result_Sink {
+
+public:
+
+    Result_Sink(std::string filename, bool append = false) : filename(filename) {
+        file = ::open(filename.c_str(), O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), 0644);
+        if(file < 0) std::cerr << "Error opening file: " << filename << std::endl;
+        writer = std::thread(&Result_Sink::drain_loop, this);
+    }
+
+    ~Result_Sink() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake_writer.notify_one();
+        writer.join();
+        if(file >= 0){
+            ::fsync(file);
+            ::close(file);
+        }
+    }
+
+    Result_Sink(const Result_Sink&) = delete;
+    Result_Sink& operator=(const Result_Sink&) = delete;
+
+    // Appends content to the output file (asynchronously), callable from any thread
+    void write(std::string content) {
+        Batch* batch = new Batch{std::move(content), pending.load(std::memory_order_relaxed)};
+        while(!pending.compare_exchange_weak(batch->next, batch, std::memory_order_release, std::memory_order_relaxed));
+        wake_writer.notify_one();
+    }
+
+    // Blocks until everything written before the call is stored on disk
+    void checkpoint() {
+        std::unique_lock<std::mutex> lock(mutex);
+        unsigned long ticket = ++checkpoints_requested;
+        wake_writer.notify_one();
+        checkpoint_done.wait(lock, [&]() { return checkpoints_done >= ticket; });
+    }
+
+private:
+
+    struct Batch {
+        std::string content;
+        Batch* next;
+    };
+
+    // the writer wakes up at least this often, as write notifies without taking the mutex
+    static constexpr std::chrono::milliseconds poll_interval{100};
+
+    std::string filename;
+    int file = -1;
+    std::atomic<Batch*> pending{nullptr};
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable wake_writer;
+    std::condition_variable checkpoint_done;
+    bool stopping = false;
+    unsigned long checkpoints_requested = 0;
+    unsigned long checkpoints_done = 0;
+
+    void drain_loop() {
+        while(true){
+            std::unique_lock<std::mutex> lock(mutex);
+            wake_writer.wait_for(lock, poll_interval, [&]() {
+                return stopping || checkpoints_requested > checkpoints_done || pending.load(std::memory_order_relaxed) != nullptr;
+            });
+            bool stop = stopping;
+            unsigned long ticket = checkpoints_requested;
+            lock.unlock();
+
+            drain();
+            if(ticket > checkpoints_done){
+                if(file >= 0) ::fsync(file);
+                lock.lock();
+                checkpoints_done = ticket;
+                lock.unlock();
+                checkpoint_done.notify_all();
+            }
+            if(stop) break;
+        }
+    }
+
+    // Writes all pending batches in the order they were pushed
+    void drain() {
+        Batch* batch = pending.exchange(nullptr, std::memory_order_acquire);
+        Batch* reversed = nullptr;
+        while(batch != nullptr){
+            Batch* next = batch->next;
+            batch->next = reversed;
+            reversed = batch;
+            batch = next;
+        }
+        std::string buffer;
+        while(reversed != nullptr){
+            buffer += reversed->content;
+            Batch* next = reversed->next;
+            delete reversed;
+            reversed = next;
+        }
+        write_all(buffer);
+    }
+
+    void write_all(const std::string& buffer) {
+        if(file < 0) return;
+        size_t offset = 0;
+        while(offset < buffer.size()){
+            ssize_t written = ::write(file, buffer.data() + offset, buffer.size() - offset);
+            if(written < 0){
+                if(errno == EINTR) continue;
+                std::cerr << "Error writing file: " << filename << std::endl;
+                return;
+            }
+            offset += written;
+        }
+    }
+};
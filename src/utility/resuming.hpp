@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <set>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <filesystem>
+
+// Resuming experiments ------------------------------------------------------------
+
+/*
+    Results already present in an output file, identified by their key columns
+    Reading the file cuts off a trailing line without newline (a result that was interrupted while being written), so results can be appended afterwards
+    Arguments:
+        - output_file: csv file with a header line, missing files contain no results
+        - key_columns: indices of the columns identifying a result, e.g. seed, n, m, mu, run (and alpha)
+*/
+class Completed_Results {
+
+public:
+
+    // no completed results
+    Completed_Results() = default;
+
+    Completed_Results(const std::string& output_file, const std::vector<int>& key_columns) {
+        std::ifstream file(output_file, std::ios_base::in | std::ios_base::binary);
+        if(!file.is_open()) return;
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+
+        size_t complete_length = content.rfind('\n') == std::string::npos ? 0 : content.rfind('\n') + 1;
+        if(complete_length < content.size()){
+            std::filesystem::resize_file(output_file, complete_length);
+            content.resize(complete_length);
+        }
+
+        std::istringstream lines(content);
+        std::string line;
+        if(!std::getline(lines, line)) return;
+        header = true;
+        while(std::getline(lines, line)){
+            std::vector<std::string> columns;
+            std::istringstream columns_stream(line);
+            std::string column;
+            while(std::getline(columns_stream, column, ',')) columns.push_back(column);
+            std::string key;
+            bool complete = true;
+            for(size_t i = 0; i < key_columns.size(); i++){
+                if(key_columns[i] >= int(columns.size())){
+                    complete = false;
+                    break;
+                }
+                key += (i == 0 ? "" : ",") + columns[key_columns[i]];
+            }
+            if(complete) keys.insert(key + "\n");
+        }
+    }
+
+    // whether the file already had a header line
+    bool has_header() const { return header; }
+
+    // whether a result with the given key (its key columns as written by get_csv_line) is present
+    bool contains(const std::string& key) const { return keys.count(key) > 0; }
+
+private:
+
+    bool header = false;
+    std::set<std::string> keys;
+};
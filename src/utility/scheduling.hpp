@@ -0,0 +1,158 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <algorithm>
+#include <functional>
+#include <assert.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Experiment scheduling -----------------------------------------------------------
+
+// One run of an experiment: population size mu, n jobs, m machines and the index of the run
+struct Experiment_Cell {
+    int mu, n, m, run;
+    double cost;
+};
+
+/*
+    Estimated cost of a run: the Mu1 algorithms run up to n^2*mu generations,
+    each mutating and evaluating one offspring (O(n)) and updating the diversity scores of the population (O(mu)),
+    independent of the number of machines
+*/
+double estimate_cost(int mu, int n){
+    return double(n) * n * mu * (n + mu);
+}
+
+/*
+    Enumerates the runs of the grid, ordered by decreasing estimated cost (ties keep the order of the grid)
+    Arguments:
+        - include: filter on (mu, n, m, run), runs it rejects are skipped (none if empty)
+*/
+std::vector<Experiment_Cell> enumerate_cells(const std::vector<int>& mus, const std::vector<int>& ns, const std::vector<int>& ms, int runs, std::function<bool(int, int, int, int)> include){
+    std::vector<Experiment_Cell> cells;
+    for(int n : ns){
+        for(int mu : mus){
+            for(int m : ms){
+                for(int run = 0; run < runs; run++){
+                    if(include && !include(mu, n, m, run)) continue;
+                    cells.push_back({mu, n, m, run, estimate_cost(mu, n)});
+                }
+            }
+        }
+    }
+    std::stable_sort(cells.begin(), cells.end(), [](const Experiment_Cell& cell1, const Experiment_Cell& cell2) {
+        return cell1.cost > cell2.cost;
+    });
+    return cells;
+}
+
+// Part index of count parts of an experiment grid, e.g. one task of a SLURM array job
+struct Shard {
+    int index = 0;
+    int count = 1;
+};
+
+/*
+    Cells of shard out of cells (ordered by decreasing cost, as returned by enumerate_cells), keeping their order
+    The cells are assigned greedily to the shard with the lowest total cost so far (lowest index on ties), so every shard gets about the same estimated cost,
+    and the partition only depends on the cells, not on which shard computes it
+*/
+std::vector<Experiment_Cell> select_shard(const std::vector<Experiment_Cell>& cells, Shard shard){
+    assert(shard.count > 0 && shard.index >= 0 && shard.index < shard.count);
+    if(shard.count == 1) return cells;
+    std::vector<double> shard_costs(shard.count, 0);
+    std::vector<Experiment_Cell> shard_cells;
+    for(const Experiment_Cell& cell : cells){
+        int target = std::min_element(shard_costs.begin(), shard_costs.end()) - shard_costs.begin();
+        shard_costs[target] += cell.cost;
+        if(target == shard.index) shard_cells.push_back(cell);
+    }
+    return shard_cells;
+}
+
+/*
+    Work stealing scheduler: the cells are dealt round robin to one queue per thread in order of decreasing cost,
+    every thread runs the most expensive cell of its own queue and, once that is empty, steals the most expensive cell of the queue with the most remaining cost
+    Every cell is run exactly once by func(mu, n, m, run), results only depend on the cell, not on the thread running it
+*/
+class Work_Stealing_Scheduler {
+
+public:
+
+    explicit Work_Stealing_Scheduler(int threads) : queues(std::max(threads, 1)) {}
+
+    void run(const std::vector<Experiment_Cell>& cells, const std::function<void(int, int, int, int)>& func){
+        for(size_t i = 0; i < cells.size(); i++){
+            Queue& queue = queues[i % queues.size()];
+            queue.cells.push_back(cells[i]);
+            queue.remaining_cost += cells[i].cost;
+        }
+        #pragma omp parallel num_threads(queues.size())
+        {
+            #ifdef _OPENMP
+            int thread = omp_get_thread_num();
+            #else
+            int thread = 0;
+            #endif
+            // if fewer threads are granted than requested, the queues of the missing threads are emptied by stealing
+            Experiment_Cell cell;
+            while(pop(thread, cell) || steal(cell)) func(cell.mu, cell.n, cell.m, cell.run);
+        }
+    }
+
+private:
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Experiment_Cell> cells;
+        double remaining_cost = 0;
+    };
+
+    std::vector<Queue> queues;
+
+    bool take_front(Queue& queue, Experiment_Cell& cell){
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if(queue.cells.empty()) return false;
+        cell = queue.cells.front();
+        queue.cells.pop_front();
+        queue.remaining_cost -= cell.cost;
+        return true;
+    }
+
+    bool pop(int thread, Experiment_Cell& cell){
+        return take_front(queues[thread], cell);
+    }
+
+    bool steal(Experiment_Cell& cell){
+        while(true){
+            int victim = -1;
+            double victim_cost = 0;
+            for(size_t i = 0; i < queues.size(); i++){
+                std::lock_guard<std::mutex> lock(queues[i].mutex);
+                if(queues[i].cells.empty()) continue;
+                if(victim == -1 || queues[i].remaining_cost > victim_cost){
+                    victim = i;
+                    victim_cost = queues[i].remaining_cost;
+                }
+            }
+            if(victim == -1) return false;
+            if(take_front(queues[victim], cell)) return true;
+        }
+    }
+};
+
+// Runs func on every cell of the grid on all available threads, most expensive cells first
+void schedule_cells(const std::vector<Experiment_Cell>& cells, const std::function<void(int, int, int, int)>& func){
+    #ifdef _OPENMP
+    int threads = omp_get_max_threads();
+    #else
+    int threads = 1;
+    #endif
+    Work_Stealing_Scheduler scheduler(threads);
+    scheduler.run(cells, func);
+}
@@ -2,6 +2,12 @@
 
 #include <vector>
 #include <numeric>
+#include <queue>
+#include <algorithm>
+#include <limits>
+#include <functional>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <assert.h>
 
@@ -9,104 +15,102 @@
 
 using T = std::vector<std::vector<int>>;
 
+/*
+    Moore-Hodgson algorithm: schedules the jobs in order of their due dates (ties by index), whenever a job is late the longest scheduled job is rejected
+    (found by a max-heap on the processing times), in O(n log n)
+    Returns the early jobs in order of their due dates followed by the rejected jobs in order of their rejection
+*/
 std::vector<int> moores_algorithm(MachineSchedulingProblem problem){
     assert(problem.processing_times.size() == problem.due_dates.size());
 
-    auto first_late = [&](std::vector<int> schedule) {
-        int current_time = 0;
-        for(int i = 0; i < schedule.size(); i++){
-            if(problem.processing_times[schedule[i]] + current_time > problem.due_dates[schedule[i]]) return i;
-            current_time += problem.processing_times[schedule[i]];
-        }
-        return -1;
-    };
-
     int n = problem.processing_times.size();
-    std::vector<int> schedule(n);
-    std::iota(schedule.begin(), schedule.end(), 0);   
-    std::vector<int> rejected_jobs;
-
-    std::sort(schedule.begin(), schedule.end(), [&](int a, int b) {
-        return problem.processing_times[a] < problem.processing_times[b];
+    std::vector<int> jobs(n);
+    std::iota(jobs.begin(), jobs.end(), 0);
+    std::stable_sort(jobs.begin(), jobs.end(), [&](int a, int b) {
+        return problem.due_dates[a] < problem.due_dates[b];
     });
 
-    while(true){
-        int first_late_index = first_late(schedule);
-        if(first_late_index == -1) break;
-        int first_late_job = schedule[first_late_index];
-        std::vector<int> early_jobs(schedule.begin(), schedule.begin() + first_late_index + 1);
-        std::vector<int> late_jobs(schedule.begin() + first_late_index + 1, schedule.end());
-        std::sort(early_jobs.begin(), early_jobs.end(), [&](int a, int b) {
-            return problem.due_dates[a] < problem.due_dates[b];
-        });
-        if(first_late(early_jobs) != -1){
-            int rejected_index = std::find(early_jobs.begin(), early_jobs.end(), first_late_job) - early_jobs.begin();
-            rejected_jobs.emplace_back(early_jobs[rejected_index]);
-            early_jobs.erase(early_jobs.begin() + rejected_index);   
+    std::priority_queue<std::pair<int, int>> scheduled_jobs;
+    std::vector<bool> rejected(n, false);
+    std::vector<int> rejected_jobs;
+    int current_time = 0;
+    for(int job : jobs){
+        scheduled_jobs.emplace(problem.processing_times[job], job);
+        current_time += problem.processing_times[job];
+        if(current_time > problem.due_dates[job]){
+            auto [processing_time, longest_job] = scheduled_jobs.top();
+            scheduled_jobs.pop();
+            current_time -= processing_time;
+            rejected[longest_job] = true;
+            rejected_jobs.emplace_back(longest_job);
         }
-        schedule = early_jobs;
-        schedule.insert(schedule.end(), late_jobs.begin(), late_jobs.end());
     }
 
+    std::vector<int> schedule;
+    schedule.reserve(n);
+    for(int job : jobs){
+        if(!rejected[job]) schedule.emplace_back(job);
+    }
     schedule.insert(schedule.end(), rejected_jobs.begin(), rejected_jobs.end());
     return schedule;
 }
 
+/*
+    Approximation algorithm for P||sum U_j: fills the machines one after another, each by Moore-Hodgson on the jobs left by the previous one,
+    improved by swapping its early jobs with the jobs it left
+    The completion times and slacks of the machine are recomputed only when a swap is committed, the candidate swaps are checked in O(log n) each,
+    using the running minimum of the slacks behind the swapped position
+*/
 T approximation_algorithm(MachineSchedulingProblem problem, int m){
 
     assert(problem.processing_times.size() == problem.due_dates.size());
 
-    auto first_late = [&](std::vector<int> schedule) {
-        int current_time = 0;
-        for(int i = 0; i < schedule.size(); i++){
-            if(problem.processing_times[schedule[i]] + current_time > problem.due_dates[schedule[i]]) return i;
-            current_time += problem.processing_times[schedule[i]];
-        }
-        return -1;
-    };
-
-    auto early_jobs_n = [&](std::vector<int> schedule) {
-        int first_late_index = first_late(schedule);
-        if(first_late_index == -1) return (int) schedule.size();
-        return first_late_index;
-    };
+    const std::vector<int>& processing_times = problem.processing_times;
+    const std::vector<int>& due_dates = problem.due_dates;
 
-    auto start_time = [&](std::vector<int> schedule, int job) {
+    // number of jobs of sequence finishing in time when run from time 0 in this order, up to the first late one
+    auto early_jobs_n = [&](const std::vector<int>& sequence) {
         int current_time = 0;
-        for(int i = 0; i < schedule.size(); i++){
-            if(schedule[i] == job) return current_time;
-            current_time += problem.processing_times[schedule[i]];
+        for(int i = 0; i < (int) sequence.size(); i++){
+            current_time += processing_times[sequence[i]];
+            if(current_time > due_dates[sequence[i]]) return i;
         }
-        return -1;
+        return (int) sequence.size();
     };
 
-    auto slacks = [&](std::vector<int> schedule) {
-        std::vector<int> slacks(schedule.size());
+    // removes late jobs from sequence until none is late, each time the longest (first on ties) of the jobs up to the first late one, appending it to removed
+    auto remove_late_jobs = [&](std::vector<int>& sequence, std::vector<int>& removed) {
+        std::priority_queue<std::pair<int, int>> scheduled_jobs;    // (processing time, -position)
+        std::vector<bool> is_removed(sequence.size(), false);
         int current_time = 0;
-        for(int i = 0; i < schedule.size(); i++){
-            current_time += problem.processing_times[schedule[i]];
-            slacks[i] = problem.due_dates[schedule[i]] - current_time;
+        for(int position = 0; position < (int) sequence.size(); position++){
+            int job = sequence[position];
+            scheduled_jobs.emplace(processing_times[job], -position);
+            current_time += processing_times[job];
+            while(!is_removed[position] && current_time > due_dates[job]){
+                int longest_position = -scheduled_jobs.top().second;
+                scheduled_jobs.pop();
+                is_removed[longest_position] = true;
+                current_time -= processing_times[sequence[longest_position]];
+                removed.emplace_back(sequence[longest_position]);
+            }
         }
-        return slacks;
-    };
-
-    auto minimum_slack = [&](std::vector<int> schedule, int start_index) {
-        int min_slack = std::numeric_limits<int>::max();
-        for (int i = start_index + 1; i < early_jobs_n(schedule); ++i) {
-            min_slack = std::min(min_slack, slacks(schedule)[i]);
+        int kept = 0;
+        for(int position = 0; position < (int) sequence.size(); position++){
+            if(!is_removed[position]) sequence[kept++] = sequence[position];
         }
-        return min_slack;
+        sequence.resize(kept);
     };
-    
+
     std::vector<std::vector<int>> schedule(m);
     std::vector<int> rejected_jobs;
     std::vector<int> unscheduled_jobs;
 
-    int n = problem.processing_times.size();
+    int n = processing_times.size();
     int k = 0;
 
     for(int i = 0; i < n; i++){
-        if(problem.processing_times[i] > problem.due_dates[i]){
+        if(processing_times[i] > due_dates[i]){
             rejected_jobs.emplace_back(i);
         } else {
             schedule[k].emplace_back(i);
@@ -114,45 +118,75 @@ T approximation_algorithm(MachineSchedulingProblem problem, int m){
     }
     
     std::sort(schedule[k].begin(), schedule[k].end(), [&](int a, int b) {
-        return problem.due_dates[a] < problem.due_dates[b];
+        return due_dates[a] < due_dates[b];
     });
 
+    std::vector<int> completion_times;
+    std::vector<int> slacks;
+    std::vector<int> minimum_slacks;
     while(true){
-        while(true){
-            int first_late_index = first_late(schedule[k]);
-            if(first_late_index == -1) break;
-            std::vector<int> early_jobs(schedule[k].begin(), schedule[k].begin() + first_late_index + 1);
-            int longest_job = *(std::max_element(early_jobs.begin(), early_jobs.end(), [&](int a, int b) {
-                return problem.processing_times[a] < problem.processing_times[b];
-            }));
-            unscheduled_jobs.emplace_back(longest_job);
-            schedule[k].erase(std::find(schedule[k].begin(), schedule[k].end(), longest_job));
-        }
+        remove_late_jobs(schedule[k], unscheduled_jobs);
         if(k >= m - 1 || unscheduled_jobs.size() == 0){
             break;
         }
-        for(int j = 0; j < early_jobs_n(schedule[k]); j++){
-            for(int i = 0; i < early_jobs_n(unscheduled_jobs); i++){
+
+        std::vector<int>& machine = schedule[k];
+        int size = machine.size();
+        int early_jobs = 0;
+        int early_unscheduled_jobs = early_jobs_n(unscheduled_jobs);
+        // completion times and slacks of machine, and its number of early jobs
+        auto update_machine = [&]() {
+            completion_times.resize(size);
+            slacks.resize(size);
+            int current_time = 0;
+            early_jobs = size;
+            for(int x = 0; x < size; x++){
+                current_time += processing_times[machine[x]];
+                completion_times[x] = current_time;
+                slacks[x] = due_dates[machine[x]] - current_time;
+                if(slacks[x] < 0 && early_jobs == size) early_jobs = x;
+            }
+        };
+        // minimum_slacks[t]: minimum slack of the positions j + 1 to j + 1 + t
+        auto update_minimum_slacks = [&](int j) {
+            minimum_slacks.resize(std::max(size - j - 1, 0));
+            int minimum = std::numeric_limits<int>::max();
+            for(int x = j + 1; x < size; x++){
+                minimum = std::min(minimum, slacks[x]);
+                minimum_slacks[x - j - 1] = minimum;
+            }
+        };
+        // minimum slack of the positions j + 1 to end - 1, shifted by -shift (maximum int if there are none)
+        auto minimum_slack = [&](int j, int end, int shift) {
+            if(end <= j + 1) return std::numeric_limits<int>::max();
+            return minimum_slacks[end - j - 2] - shift;
+        };
+
+        update_machine();
+        for(int j = 0; j < early_jobs; j++){
+            update_minimum_slacks(j);
+            for(int i = 0; i < early_unscheduled_jobs; i++){
                 int unscheduled_job = unscheduled_jobs[i];
-                int scheduled_job = schedule[k][j];
-                std::vector<int> schedule_(schedule[k]);
-                std::vector<int> unscheduled_jobs_(unscheduled_jobs);
-                schedule_[j] = unscheduled_job;
-                unscheduled_jobs_[i] = scheduled_job;
+                int scheduled_job = machine[j];
+                int start_time = completion_times[j] - processing_times[scheduled_job];
+                int shift = processing_times[unscheduled_job] - processing_times[scheduled_job];
+                if(due_dates[unscheduled_job] < start_time + processing_times[unscheduled_job]) continue;
+                if(minimum_slack(j, early_jobs, 0) < shift) continue;
+                // early jobs after swapping: the positions up to j stay early, behind j the first position with a slack below shift is late
+                int swapped_early_jobs = j + 1 + (std::lower_bound(minimum_slacks.begin(), minimum_slacks.end(), shift, std::greater_equal<int>()) - minimum_slacks.begin());
                 if(
-                    problem.due_dates[unscheduled_job] >= start_time(schedule[k], scheduled_job) + problem.processing_times[unscheduled_job] &&
-                    minimum_slack(schedule[k], j) >= problem.processing_times[unscheduled_job] - problem.processing_times[scheduled_job] &&
+                    minimum_slack(j, swapped_early_jobs, shift) > due_dates[unscheduled_job] - start_time - processing_times[unscheduled_job] ||
                     (
-                        minimum_slack(schedule_, j) > problem.due_dates[unscheduled_job] - start_time(schedule[k], scheduled_job) - problem.processing_times[unscheduled_job] ||
-                        (
-                            problem.due_dates[unscheduled_job] > problem.due_dates[scheduled_job] &&
-                            problem.processing_times[unscheduled_job] > problem.processing_times[scheduled_job] &&
-                            (problem.processing_times[unscheduled_job] - problem.processing_times[scheduled_job]) * (early_jobs_n(schedule_) - j + 2) > (problem.due_dates[unscheduled_job] - problem.due_dates[scheduled_job])
-                        )
+                        due_dates[unscheduled_job] > due_dates[scheduled_job] &&
+                        processing_times[unscheduled_job] > processing_times[scheduled_job] &&
+                        shift * (swapped_early_jobs - j + 2) > (due_dates[unscheduled_job] - due_dates[scheduled_job])
                     )
                 ){
-                    schedule[k] = schedule_;
-                    unscheduled_jobs = unscheduled_jobs_;
+                    machine[j] = unscheduled_job;
+                    unscheduled_jobs[i] = scheduled_job;
+                    update_machine();
+                    update_minimum_slacks(j);
+                    early_unscheduled_jobs = early_jobs_n(unscheduled_jobs);
                 }
             }
         }
@@ -169,4 +203,274 @@ T approximation_algorithm(MachineSchedulingProblem problem, int m){
     }
 
     return schedule;
-}
\ No newline at end of file
+}
+
+// Schedule found by exact_algorithm with its number of tardy jobs and a lower bound on OPT (equal to it if the schedule is optimal)
+struct Exact_Solution {
+    T schedule;
+    int tardy_jobs;
+    int lower_bound;
+    bool optimal;
+};
+
+/*
+    Branch and bound for P||sum U_j: decides the jobs in order of their due dates (ties by index), appending each to a machine it is early on or rejecting it
+    (early jobs in order of their due dates are early on their machine); of the machines with equal loads only the first is tried, the fullest first
+    A node is pruned if its early jobs plus an upper bound on the early jobs to come do not beat the best schedule: Moore-Hodgson on a single machine
+    that completes by time d as much work as all machines together, sum_i max(0, d - load_i), on the jobs fitting on the least loaded machine
+*/
+class Tardy_Jobs_Branch_And_Bound {
+
+public:
+
+    Tardy_Jobs_Branch_And_Bound(const MachineSchedulingProblem& problem, int m) : problem(problem), m(m) {
+        int n = problem.processing_times.size();
+        for(int job = 0; job < n; job++){
+            if(problem.processing_times[job] <= problem.due_dates[job]) jobs.emplace_back(job);
+        }
+        std::stable_sort(jobs.begin(), jobs.end(), [&](int a, int b) {
+            return problem.due_dates[a] < problem.due_dates[b];
+        });
+    }
+
+    // upper bound on the early jobs of any schedule
+    int early_jobs_bound() const {
+        return early_jobs_bound(0, std::vector<int>(m, 0));
+    }
+
+    /*
+        Searches for a schedule with more early jobs than initial_schedule, the subtrees below the first levels are searched in parallel
+        The schedule returned does not depend on the number of threads or their timing if the search finishes within time_limit (seconds)
+    */
+    Exact_Solution solve(const T& initial_schedule, double time_limit) {
+        int n = problem.processing_times.size();
+        int initial_early_jobs = early_jobs(initial_schedule);
+        deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(time_limit));
+        timed_out = false;
+
+        std::vector<Node> frontier = expand_frontier(initial_early_jobs);
+        std::vector<Search> searches(frontier.size());
+        std::atomic<int> shared_best(initial_early_jobs);
+        #pragma omp parallel for schedule(dynamic, 1)
+        for(int i = 0; i < (int) frontier.size(); i++){
+            searches[i].node = frontier[i];
+            searches[i].best_early_jobs = initial_early_jobs;
+            search(searches[i], shared_best);
+        }
+
+        int best = -1;
+        int upper_bound = initial_early_jobs;
+        for(int i = 0; i < (int) searches.size(); i++){
+            if(searches[i].best_early_jobs > initial_early_jobs && (best < 0 || searches[i].best_early_jobs > searches[best].best_early_jobs)) best = i;
+            upper_bound = std::max(upper_bound, searches[i].finished ? searches[i].best_early_jobs : bound(frontier[i]));
+        }
+
+        Exact_Solution solution;
+        if(best < 0){
+            solution.schedule = initial_schedule;
+            solution.tardy_jobs = n - initial_early_jobs;
+        }else{
+            solution.schedule = to_schedule(searches[best].best_machines);
+            solution.tardy_jobs = n - searches[best].best_early_jobs;
+        }
+        solution.lower_bound = n - upper_bound;
+        solution.optimal = solution.lower_bound == solution.tardy_jobs;
+        return solution;
+    }
+
+private:
+
+    struct Node {
+        int early_jobs = 0;
+        std::vector<int> loads;
+        std::vector<int> machines;    // machine of every decided job (in order of jobs), -1 if rejected
+    };
+
+    struct Search {
+        Node node;
+        int best_early_jobs = 0;
+        std::vector<int> best_machines;
+        bool finished = true;
+    };
+
+    // the subtrees below the frontier are searched in parallel, independent of the number of threads
+    static constexpr int frontier_size = 256;
+    static constexpr int nodes_per_time_check = 1024;
+
+    const MachineSchedulingProblem& problem;
+    int m;
+    std::vector<int> jobs;    // jobs that can be early, in order of their due dates
+    std::chrono::steady_clock::time_point deadline;
+    std::atomic<bool> timed_out{false};
+
+    // upper bound on the early jobs among jobs[depth], jobs[depth + 1], ... given the loads of the machines
+    int early_jobs_bound(int depth, const std::vector<int>& loads) const {
+        int minimum_load = *std::min_element(loads.begin(), loads.end());
+        std::priority_queue<int> kept_jobs;
+        long long work = 0;
+        for(int i = depth; i < (int) jobs.size(); i++){
+            int job = jobs[i];
+            if(minimum_load + problem.processing_times[job] > problem.due_dates[job]) continue;
+            kept_jobs.push(problem.processing_times[job]);
+            work += problem.processing_times[job];
+            long long capacity = 0;
+            for(int load : loads) capacity += std::max(0, problem.due_dates[job] - load);
+            if(work > capacity){
+                work -= kept_jobs.top();
+                kept_jobs.pop();
+            }
+        }
+        return kept_jobs.size();
+    }
+
+    int bound(const Node& node) const {
+        return node.early_jobs + early_jobs_bound(node.machines.size(), node.loads);
+    }
+
+    // machines to append the next job to (-1: reject it), in the order they are tried
+    std::vector<int> branches(const Node& node) const {
+        int job = jobs[node.machines.size()];
+        std::vector<int> machines(m);
+        std::iota(machines.begin(), machines.end(), 0);
+        std::stable_sort(machines.begin(), machines.end(), [&](int a, int b) {
+            return node.loads[a] > node.loads[b];
+        });
+        std::vector<int> result;
+        for(int i = 0; i < m; i++){
+            if(i > 0 && node.loads[machines[i]] == node.loads[machines[i - 1]]) continue;
+            if(node.loads[machines[i]] + problem.processing_times[job] <= problem.due_dates[job]) result.emplace_back(machines[i]);
+        }
+        result.emplace_back(-1);
+        return result;
+    }
+
+    void apply(Node& node, int machine) const {
+        if(machine >= 0){
+            node.loads[machine] += problem.processing_times[jobs[node.machines.size()]];
+            node.early_jobs++;
+        }
+        node.machines.emplace_back(machine);
+    }
+
+    void undo(Node& node) const {
+        int machine = node.machines.back();
+        node.machines.pop_back();
+        if(machine >= 0){
+            node.loads[machine] -= problem.processing_times[jobs[node.machines.size()]];
+            node.early_jobs--;
+        }
+    }
+
+    // nodes of the first levels of the tree in depth first order, without the ones that cannot beat initial_early_jobs
+    std::vector<Node> expand_frontier(int initial_early_jobs) const {
+        Node root;
+        root.loads.assign(m, 0);
+        std::vector<Node> frontier;
+        if(bound(root) > initial_early_jobs) frontier.emplace_back(root);
+        bool expandable = true;
+        while(expandable && !frontier.empty() && (int) frontier.size() < frontier_size){
+            expandable = false;
+            std::vector<Node> next_frontier;
+            for(const Node& node : frontier){
+                if(node.machines.size() == jobs.size()){
+                    next_frontier.emplace_back(node);
+                    continue;
+                }
+                for(int machine : branches(node)){
+                    Node child = node;
+                    apply(child, machine);
+                    if(bound(child) <= initial_early_jobs) continue;
+                    next_frontier.emplace_back(std::move(child));
+                    expandable = true;
+                }
+            }
+            frontier = std::move(next_frontier);
+        }
+        return frontier;
+    }
+
+    // depth first search below search.node, a node is pruned if it cannot beat the best schedule of this search or of all searches
+    void search(Search& search, std::atomic<int>& shared_best) {
+        long long nodes = 0;
+        visit(search, shared_best, nodes);
+    }
+
+    void visit(Search& search, std::atomic<int>& shared_best, long long& nodes) {
+        if(++nodes % nodes_per_time_check == 0 && std::chrono::steady_clock::now() > deadline) timed_out = true;
+        if(timed_out){
+            search.finished = false;
+            return;
+        }
+        Node& node = search.node;
+        if(node.machines.size() == jobs.size()){
+            if(node.early_jobs > search.best_early_jobs){
+                search.best_early_jobs = node.early_jobs;
+                search.best_machines = node.machines;
+                int best = shared_best.load();
+                while(best < node.early_jobs && !shared_best.compare_exchange_weak(best, node.early_jobs));
+            }
+            return;
+        }
+        int node_bound = bound(node);
+        if(node_bound <= search.best_early_jobs || node_bound < shared_best.load()) return;
+        for(int machine : branches(node)){
+            apply(node, machine);
+            visit(search, shared_best, nodes);
+            undo(node);
+            if(!search.finished) return;
+        }
+    }
+
+    // early jobs in order of their due dates on their machines, followed by the tardy jobs distributed over the machines
+    T to_schedule(const std::vector<int>& machines) const {
+        T schedule(m);
+        std::vector<bool> early(problem.processing_times.size(), false);
+        for(int i = 0; i < (int) machines.size(); i++){
+            if(machines[i] < 0) continue;
+            schedule[machines[i]].emplace_back(jobs[i]);
+            early[jobs[i]] = true;
+        }
+        int t = 0;
+        for(int job = 0; job < (int) early.size(); job++){
+            if(early[job]) continue;
+            schedule[t].emplace_back(job);
+            t = (t + 1) % m;
+        }
+        return schedule;
+    }
+
+    int early_jobs(const T& schedule) const {
+        int early = 0;
+        for(const auto& machine : schedule){
+            int current_time = 0;
+            for(int job : machine){
+                current_time += problem.processing_times[job];
+                if(current_time <= problem.due_dates[job]) early++;
+            }
+        }
+        return early;
+    }
+};
+
+/*
+    Exact algorithm for P||sum U_j: branch and bound (Tardy_Jobs_Branch_And_Bound) starting from the approximation algorithm, Moore-Hodgson for m = 1
+    Arguments:
+        - time_limit: seconds, when reached the best schedule found so far is returned (at least as good as the approximation algorithm) with a lower bound on OPT
+*/
+Exact_Solution exact_algorithm(MachineSchedulingProblem problem, int m, double time_limit){
+    int n = problem.processing_times.size();
+    if(m == 1){
+        T schedule = {moores_algorithm(problem)};
+        Tardy_Jobs_Branch_And_Bound solver(problem, m);
+        int tardy = n - solver.early_jobs_bound();
+        return {schedule, tardy, tardy, true};
+    }
+    Tardy_Jobs_Branch_And_Bound solver(problem, m);
+    return solver.solve(approximation_algorithm(problem, m), time_limit);
+}
+
+// Lower bound on the tardy jobs of any schedule (see Tardy_Jobs_Branch_And_Bound)
+int tardy_jobs_lower_bound(MachineSchedulingProblem problem, int m){
+    Tardy_Jobs_Branch_And_Bound solver(problem, m);
+    return problem.processing_times.size() - solver.early_jobs_bound();
+}
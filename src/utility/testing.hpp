@@ -2,12 +2,22 @@
 
 #include <iostream>
 #include <chrono>
+#include <map>
+#include <set>
+#include <tuple>
+#include <filesystem>
+#include <memory>
 
 #include "../algorithms/simple.hpp"
 #include "../algorithms/mu1.hpp"
 #include "../utility/generating.hpp"
 #include "../utility/documenting.hpp"
 #include "../utility/solvers.hpp"
+#include "../utility/scheduling.hpp"
+#include "../utility/result_sink.hpp"
+#include "../utility/resuming.hpp"
+#include "../utility/instance_cache.hpp"
+#include "../utility/performance_counters.hpp"
 
 using T = std::vector<std::vector<int>>;
 using L = double;
@@ -22,52 +32,134 @@ bool is_viable_combination(int mu, int n, int m){
     return (m < n) && (mu <= (n*n - n)/(n-m));
 }
 
-void loop_parameters(std::vector<int> mus, std::vector<int> ns, std::vector<int> ms, int runs, std::function<void(int, int, int, int)> func){
-    #pragma omp parallel for collapse(4)
-    for(int n : ns){
-        for(int mu : mus){
-            for(int m : ms){
-                for(int run = 0; run < runs; run++) func(mu, n, m, run);
-            }
+/*
+    Runs func(mu, n, m, run) on every combination in parallel, longest runs first
+    Arguments:
+        - viable_only: skip the combinations rejected by is_viable_combination
+        - shard: only run the part of the combinations belonging to shard (see select_shard)
+        - pending: if set, skip the runs for which it returns false (e.g. runs whose results are already present),
+          applied after sharding, so the shards do not depend on progress
+*/
+void loop_parameters(std::vector<int> mus, std::vector<int> ns, std::vector<int> ms, int runs, std::function<void(int, int, int, int)> func, bool viable_only = true, Shard shard = {}, std::function<bool(int, int, int, int)> pending = nullptr){
+    std::function<bool(int, int, int, int)> viable;
+    if(viable_only) viable = [](int mu, int n, int m, int run) -> bool { return is_viable_combination(mu, n, m); };
+    std::vector<Experiment_Cell> cells = select_shard(enumerate_cells(mus, ns, ms, runs, viable), shard);
+    if(pending != nullptr){
+        cells.erase(std::remove_if(cells.begin(), cells.end(), [&pending](const Experiment_Cell& cell) {
+            return !pending(cell.mu, cell.n, cell.m, cell.run);
+        }), cells.end());
+    }
+    schedule_cells(cells, func);
+}
+
+// Time limit (seconds) of the exact algorithm computing the reference schedules for m > 1, 0 to use the approximation algorithm (set by main, see --exact-opt)
+double exact_time_limit = 0;
+
+// Solver and time limit of the reference schedules of instances with m machines, given exact_time_limit
+Reference_Solver reference_solver(int m) {
+    if (m == 1) return Reference_Solver::moore;
+    return exact_time_limit > 0 ? Reference_Solver::exact : Reference_Solver::approximation;
+}
+
+double reference_time_limit(int m) {
+    return reference_solver(m) == Reference_Solver::exact ? exact_time_limit : 0;
+}
+
+// Whether the reference schedule of instance was computed by the solver and time limit compute_instance uses now
+bool reference_matches(const Instance& instance) {
+    return instance.solver == reference_solver(instance.m) && instance.time_limit == reference_time_limit(instance.m);
+}
+
+// Generates the instance of a run and computes its reference schedule
+Instance compute_instance(int seed, int n, int max_processing_time, int m) {
+    Instance instance{seed, n, max_processing_time, m, get_problem(seed, n, max_processing_time), 0, {}, 0, reference_solver(m), reference_time_limit(m)};
+    int lower_bound = tardy_jobs_lower_bound(instance.problem, m);
+    if (m == 1) instance.optimal_solution = {moores_algorithm(instance.problem)};
+    else if (exact_time_limit > 0) {
+        Exact_Solution solution = exact_algorithm(instance.problem, m, exact_time_limit);
+        instance.optimal_solution = solution.schedule;
+        lower_bound = solution.lower_bound;
+        if(!solution.optimal){
+            std::cerr << "Exact algorithm reached the time limit (seed " + std::to_string(seed) + ", n " + std::to_string(n) + ", m " + std::to_string(m) + "): "
+                + std::to_string(solution.tardy_jobs) + " tardy jobs, OPT >= " + std::to_string(solution.lower_bound)
+                + " (gap " + std::to_string(solution.tardy_jobs - solution.lower_bound) + ")\n";
         }
     }
+    else instance.optimal_solution = approximation_algorithm(instance.problem, m);
+    instance.OPT = tardy_jobs(instance.problem, instance.optimal_solution);
+    instance.OPT_lower_bound = lower_bound;
+    return instance;
 }
 
-std::tuple<int, T> get_optimal_solution(MachineSchedulingProblem problem, int m, std::function<std::vector<L>(const std::vector<T>&)> evaluate) {
-    T optimal_solution;
-    if (m == 1) optimal_solution = {moores_algorithm(problem)};
-    else optimal_solution = approximation_algorithm(problem, m);
-    int OPT = evaluate({optimal_solution})[0];
-    return std::make_tuple(OPT, optimal_solution);
+/*
+    Instance of a run, taken from the shared instance cache if it contains it, computed otherwise
+    Cached instances whose reference schedule stems from another solver or time limit (see reference_matches) are computed again
+*/
+Instance get_instance(int seed, int n, int max_processing_time, int m) {
+    Instance instance;
+    if(Instance_Cache::shared().lookup(seed, n, max_processing_time, m, instance) && reference_matches(instance)) return instance;
+    return compute_instance(seed, n, max_processing_time, m);
 }
 
-std::tuple<std::function<std::vector<L>(const std::vector<T>&)>, std::function<double(const T&, const T&)>, std::function<double(const std::vector<T>&)>> get_eval_div_funcs(MachineSchedulingProblem problem){
-    std::function<std::vector<L>(const std::vector<T>&)> evaluate = evaluate_tardyjobs(problem);
-    std::function<double(const T&, const T&)> diversity_measure = diversity_DFM();
-    std::function<double(const std::vector<T>&)> diversity_value = diversity_vector(diversity_measure);
+template <typename G = T>
+std::tuple<int, G> get_optimal_solution(const Instance& instance) {
+    return std::make_tuple(instance.OPT, make_gene<G>(instance.optimal_solution));
+}
+
+template <typename G = T>
+std::tuple<std::function<std::vector<L>(const std::vector<G>&)>, std::function<double(const G&, const G&)>, std::function<double(const std::vector<G>&)>> get_eval_div_funcs(MachineSchedulingProblem problem){
+    std::function<std::vector<L>(const std::vector<G>&)> evaluate = evaluate_tardyjobs<G>(problem);
+    std::function<double(const G&, const G&)> diversity_measure = diversity_DFM<G>();
+    std::function<double(const std::vector<G>&)> diversity_value = diversity_vector(diversity_measure);
     return std::make_tuple(evaluate, diversity_measure, diversity_value);
 }
 
+// Key columns of the results of test_algorithm: seed, n, m, mu, run (and alpha for "Mu1-const")
+std::vector<int> result_key_columns(std::string algorithm){
+    std::vector<int> key_columns = {0, 1, 2, 3, 4};
+    if(algorithm == "Mu1-const") key_columns.push_back(12);
+    return key_columns;
+}
+
+// Whether completed contains the results of the run for all alphas
+bool run_completed(const Completed_Results& completed, std::string algorithm, const std::vector<double>& alphas, int mu, int n, int m, int run){
+    int seed = generate_seed(mu, n, m, run);
+    if(algorithm != "Mu1-const") return completed.contains(get_csv_line(seed, n, m, mu, run));
+    for(double alpha : alphas){
+        if(!completed.contains(get_csv_line(seed, n, m, mu, run, alpha))) return false;
+    }
+    return true;
+}
+
+// File of the population checkpoint of a run in checkpoint_directory, empty if checkpoint_directory is (no checkpoints)
+std::string checkpoint_file(std::string checkpoint_directory, std::string key){
+    if(checkpoint_directory.empty()) return "";
+    std::replace(key.begin(), key.end(), ',', '_');
+    key.erase(std::remove(key.begin(), key.end(), '\n'), key.end());
+    return checkpoint_directory + "/" + key + ".bin";
+}
+
 // Test functions ------------------------------------------------------------------
 
-void test_base(std::vector<int> mus, std::vector<int> ns, std::vector<int> ms, std::vector<double> alphas, int runs, std::string output_file, std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> mutation_operator){
+void test_base(std::vector<int> mus, std::vector<int> ns, std::vector<int> ms, std::vector<double> alphas, int runs, std::string output_file, std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> mutation_operator, Shard shard = {}){
     
     int max_processing_time = 50;
-    write_to_file("", output_file, false);
+    Result_Sink sink(output_file);
 
-    auto base_test = [alphas, output_file, max_processing_time, mutation_operator](int mu, int n, int m, int run) {
+    auto base_test = [&sink, alphas, max_processing_time, mutation_operator](int mu, int n, int m, int run) {
 
         int seed = generate_seed(mu, n, m, run);
-        MachineSchedulingProblem problem = get_problem(seed, n, max_processing_time);
+        Instance instance = get_instance(seed, n, max_processing_time, m);
+        MachineSchedulingProblem problem = instance.problem;
         auto [evaluate, diversity_measure, diversity_value] = get_eval_div_funcs(problem);
-        auto [OPT, optimal_solution] = get_optimal_solution(problem, m, evaluate);
+        auto [OPT, optimal_solution] = get_optimal_solution(instance);
 
         Population<T,L> simple_pop = simple_test(
             seed,
             initialize_random(mu, n, m), evaluate, mutation_operator, select_roulette(mu), select_mu(mu, evaluate),
             300
         );
-        write_to_file(createPopulationReport(simple_pop, evaluate, diversity_value, "Simple", mu, n, m, OPT) + "\n", output_file);
+        sink.write(createPopulationReport(simple_pop, evaluate, diversity_value, "Simple", mu, n, m, OPT) + "\n");
         
         for(double alpha : alphas){
             Population<T,L>  mu1_const_pop = mu1_constrained(
@@ -75,41 +167,43 @@ void test_base(std::vector<int> mus, std::vector<int> ns, std::vector<int> ms, s
                 terminate_generations(2500), evaluate, mutation_operator, diversity_measure,
                 alpha, optimal_solution
             );
-            write_to_file(createPopulationReport(mu1_const_pop, evaluate, diversity_value, "Mu1-const " + std::to_string(alpha), mu, n, m, OPT) + "\n", output_file);
+            sink.write(createPopulationReport(mu1_const_pop, evaluate, diversity_value, "Mu1-const " + std::to_string(alpha), mu, n, m, OPT) + "\n");
         }
         
         Population<T,L>  mu1_unconst_pop = mu1_unconstrained(
             seed, m, n, mu,
             terminate_generations(2500), evaluate, mutation_operator, diversity_measure
         );
-        write_to_file(createPopulationReport(mu1_unconst_pop, evaluate, diversity_value, "Mu1-unconst", mu, n, m, OPT) + "\n", output_file);
+        sink.write(createPopulationReport(mu1_unconst_pop, evaluate, diversity_value, "Mu1-unconst", mu, n, m, OPT) + "\n");
 
    };
 
-    loop_parameters(mus, ns, ms, runs, base_test);
+    loop_parameters(mus, ns, ms, runs, base_test, false, shard);
 }   
 
-void test_mu1_optimization(std::vector<int> mus, std::vector<int> ns, std::vector<int> ms, int runs, std::string output_file, std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> mutation_operator){
+void test_mu1_optimization(std::vector<int> mus, std::vector<int> ns, std::vector<int> ms, int runs, std::string output_file, std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> mutation_operator, Shard shard = {}){
     
-    write_to_file("type,seed,n,m,mu,run,generations,max_generations,diversity,fitness,runtime\n", output_file, false);
+    Result_Sink sink(output_file);
+    sink.write("type,seed,n,m,mu,run,generations,max_generations,diversity,fitness,runtime\n");
     int max_processing_time = 50;
 
-    auto mu1_optimization_test = [runs, output_file, max_processing_time, mutation_operator](int mu, int n, int m, int run) {
+    auto mu1_optimization_test = [&sink, runs, max_processing_time, mutation_operator](int mu, int n, int m, int run) {
 
         if(!is_viable_combination(mu, n, m)) return;
 
         int seed = generate_seed(mu, n, m, run);
-        MachineSchedulingProblem problem = get_problem(seed, n, max_processing_time);
+        Instance instance = get_instance(seed, n, max_processing_time, m);
+        MachineSchedulingProblem problem = instance.problem;
         auto [evaluate, diversity_measure, diversity_value] = get_eval_div_funcs(problem);
-        auto [OPT, optimal_solution] = get_optimal_solution(problem, m, evaluate);
+        auto [OPT, optimal_solution] = get_optimal_solution(instance);
         auto start = std::chrono::high_resolution_clock::now();
         Population_Mu1<T,L>  opt_pop = mu1_unconstrained(
             seed, 1, n, mu,
             terminate_diversitygenerations(1, true, diversity_measure, n*n*mu), evaluate, mutation_operator, diversity_measure
         );
         auto stop = std::chrono::high_resolution_clock::now();
-        std::string result_opt = get_csv_line("opt", seed, n, m, mu, run, opt_pop.get_generation(), n*n*mu, diversity_value(opt_pop.get_genes(true)), evaluate({opt_pop.get_bests(false, evaluate)[0]})[0], std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count());
-        write_to_file(result_opt, output_file);
+        std::string result_opt = get_csv_line("opt", seed, n, m, mu, run, opt_pop.get_generation(), n*n*mu, opt_pop.get_diversity(diversity_value), evaluate({opt_pop.get_bests(false, evaluate)[0]})[0], std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count());
+        sink.write(result_opt);
 
         start = std::chrono::high_resolution_clock::now();
         Population<T,L>  unopt_pop = mu1_unconstrained_unoptimized(
@@ -118,53 +212,206 @@ void test_mu1_optimization(std::vector<int> mus, std::vector<int> ns, std::vecto
         );
         stop = std::chrono::high_resolution_clock::now();
         std::string result_unopt = get_csv_line("unopt", seed, n, m, mu, run, unopt_pop.get_generation(), n*n*mu, diversity_value(unopt_pop.get_genes(true)), evaluate({unopt_pop.get_bests(false, evaluate)[0]})[0], std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count());
-        write_to_file(result_unopt, output_file);
+        sink.write(result_unopt);
     };
 
-    loop_parameters(mus, ns, ms, runs, mu1_optimization_test);
+    loop_parameters(mus, ns, ms, runs, mu1_optimization_test, true, shard);
 }
 
-void test_algorithm(std::vector<int> mus, std::vector<int> ns, std::vector<int> ms, std::vector<double> alphas, int runs, std::string output_file, std::string algorithm, std::string operator_string, std::function<std::vector<T>(const std::vector<T>&, std::mt19937&)> mutation_operator){
+/*
+    Runs algorithm on every run of the grid, writing one csv line per run (and alpha) to output_file
+    With resume, the results already in output_file are kept and only the missing ones are computed,
+    the Mu1 populations are checkpointed in output_file.checkpoints, so interrupted runs continue from their last checkpoint
+    With record_component_times, every line additionally holds the time and calls per component of the generations (see Component_Times),
+    with record_performance_counters the performance counters of the run, counted in the thread running it (see Performance_Counters)
+    With trajectory (a sampling, see parse_trajectory_sampling), the trajectories of the Mu1 runs are recorded into output_file.trajectory (see Trajectory_Recorder)
+    With lambda > 1, the Mu1 runs create lambda offspring per generation, selected greedily or one after another (see mu1_unconstrained_delta),
+    their generations count offspring (and may exceed the budget n*n*mu by less than lambda)
+    diversity selects how the Mu1 runs compute the DFM scores of their offspring: "successor" (derived from successor tables), "bitset-dense" or "bitset-sliced"
+    (compared on edge bitset encodings, see diversity_DFM_bitset, only for lambda = 1)
+*/
+template <typename G = T>
+void test_algorithm(std::vector<int> mus, std::vector<int> ns, std::vector<int> ms, std::vector<double> alphas, int runs, std::string output_file, std::string algorithm, std::string operator_string, std::function<std::vector<G>(const std::vector<G>&, std::mt19937&)> mutation_operator, std::function<void(const std::vector<G>&, std::vector<G>&, std::vector<Offspring_Delta>&, std::mt19937&)> mutation_operator_delta, bool resume = false, Shard shard = {}, bool record_component_times = false, bool record_performance_counters = false, std::string trajectory = "", int lambda = 1, bool greedy = false, std::string diversity = "successor"){
    
     std::string header = "seed,n,m,mu,run,generations,max_generations,diversity,fitness,opt,algorithm,mutation";
-    header += algorithm == "Mu1-const" ? ",alpha\n" : "\n";
-    write_to_file(header, output_file, false);
+    header += algorithm == "Mu1-const" ? ",alpha" : "";
+    header += record_component_times ? get_component_times_header() : "";
+    header += record_performance_counters ? get_performance_counters_header() + "\n" : "\n";
+    Completed_Results completed = resume ? Completed_Results(output_file, result_key_columns(algorithm)) : Completed_Results();
+    Result_Sink sink(output_file, resume);
+    if(!completed.has_header()) sink.write(header);
+    std::string checkpoint_directory = resume ? output_file + ".checkpoints" : "";
+    if(resume) std::filesystem::create_directories(checkpoint_directory);
     int max_processing_time = 50;
+    std::unique_ptr<Result_Sink> trajectory_sink = trajectory.empty() ? nullptr : std::make_unique<Result_Sink>(output_file + ".trajectory", resume);
+    Trajectory_Sampling trajectory_sampling = trajectory.empty() ? Trajectory_Sampling() : parse_trajectory_sampling(trajectory);
+
+    // appends the component times and performance counters of a run to its csv line, if they are recorded
+    auto with_records = [record_component_times](std::string line, const Component_Times& times, const Performance_Counters* performance_counters) -> std::string {
+        std::string columns = record_component_times ? get_component_times_columns(times) : "";
+        if(performance_counters != nullptr) columns += get_performance_counters_columns(*performance_counters);
+        line.insert(line.size() - 1, columns);
+        return line;
+    };
+
+    // termination of a Mu1 run, recording its trajectory into recorder if trajectories are recorded
+    auto with_trajectory = [&trajectory_sink, trajectory_sampling](std::function<bool(Population<G,L>&)> termination, std::unique_ptr<Trajectory_Recorder>& recorder, Trajectory_Run run, std::function<double(const std::vector<G>&)> diversity_value, std::function<std::vector<L>(const std::vector<G>&)> evaluate) {
+        if(trajectory_sink == nullptr) return termination;
+        recorder = std::make_unique<Trajectory_Recorder>(*trajectory_sink, run, trajectory_sampling);
+        return terminate_recording<G>(termination, *recorder, diversity_value, evaluate);
+    };
 
-    auto algorithm_test = [output_file, max_processing_time, algorithm, mutation_operator, alphas, operator_string](int mu, int n, int m, int run) {
+    auto algorithm_test = [&sink, &completed, &with_records, &with_trajectory, checkpoint_directory, resume, record_component_times, record_performance_counters, lambda, greedy, diversity, max_processing_time, algorithm, mutation_operator, mutation_operator_delta, alphas, operator_string](int mu, int n, int m, int run) {
 
         if(!is_viable_combination(mu, n, m)) return;
+        // memory of pooled gene layouts, released at the end of the run
+        Gene_Pool_Scope gene_pool(mu, n, m);
 
         int seed = generate_seed(mu, n, m, run);
-        MachineSchedulingProblem problem = get_problem(seed, n, max_processing_time);
-        auto [evaluate, diversity_measure, diversity_value] = get_eval_div_funcs(problem);
-        auto [OPT, optimal_solution] = get_optimal_solution(problem, m, evaluate);
+        Instance instance = get_instance(seed, n, max_processing_time, m);
+        MachineSchedulingProblem problem = instance.problem;
+        auto [evaluate, diversity_measure, diversity_value] = get_eval_div_funcs<G>(problem);
+        auto [OPT, optimal_solution] = get_optimal_solution<G>(instance);
+        Edge_Diversity<G> edge_diversity = diversity == "successor" ? Edge_Diversity<G>() : diversity_DFM_bitset<G>(n, diversity == "bitset-dense" ? Edge_Encoding::dense : Edge_Encoding::sliced);
         std::string result;
+        std::vector<std::string> checkpoint_files;
+        Component_Times times;
+        Component_Times* component_times = record_component_times ? &times : nullptr;
+        std::unique_ptr<Performance_Counters> performance_counters = record_performance_counters ? std::make_unique<Performance_Counters>() : nullptr;
+        auto start_counters = [&performance_counters]() { if(performance_counters != nullptr) performance_counters->start(); };
+        auto stop_counters = [&performance_counters]() { if(performance_counters != nullptr) performance_counters->stop(); };
+        std::unique_ptr<Trajectory_Recorder> recorder;
         if(algorithm == "Simple"){
-            Population<T,L> population = simple_test(
+            start_counters();
+            Population<G,L> population = simple_test(
                 seed,
-                initialize_random(mu, n, m), evaluate, mutation_operator, select_roulette(mu), select_mu(mu, evaluate),
-                300
+                initialize_random<G>(mu, n, m), evaluate, mutation_operator, select_roulette<G>(mu), select_mu(mu, evaluate),
+                300, component_times
             );
-            result += get_csv_line(seed, n, m, mu, run, population.get_generation(), n*n*mu, diversity_value(population.get_genes(true)), population.get_best_fitness(evaluate), OPT, algorithm, operator_string);
+            stop_counters();
+            result += with_records(get_csv_line(seed, n, m, mu, run, population.get_generation(), n*n*mu, population.get_diversity(diversity_value), population.get_best_fitness(evaluate), OPT, algorithm, operator_string), times, performance_counters.get());
         }else if(algorithm == "Mu1-unconst"){
-            Population<T,L> population = mu1_unconstrained(
+            checkpoint_files.push_back(checkpoint_file(checkpoint_directory, get_csv_line(seed, n, m, mu, run)));
+            start_counters();
+            Population_Mu1<G,L> population = mu1_unconstrained_delta(
                 seed, m, n, mu,
-                terminate_diversitygenerations(1, true, diversity_measure, n*n*mu), evaluate, mutation_operator, diversity_measure
+                with_trajectory(terminate_diversitygenerations<G>(1, true, diversity_measure, n*n*mu), recorder, {seed, n, m, mu, run, std::nan(""), algorithm, operator_string}, diversity_value, evaluate),
+                evaluate, mutation_operator_delta, checkpoint_files.back(), component_times, lambda, greedy, edge_diversity
             );
-            result += get_csv_line(seed, n, m, mu, run, population.get_generation(), n*n*mu, diversity_value(population.get_genes(true)), population.get_best_fitness(evaluate), OPT, algorithm, operator_string);
+            stop_counters();
+            result += with_records(get_csv_line(seed, n, m, mu, run, population.get_generation(), n*n*mu, population.get_diversity(diversity_value), population.get_best_fitness(evaluate), OPT, algorithm, operator_string), times, performance_counters.get());
         }else if(algorithm == "Mu1-const"){
             for(double alpha: alphas){
-                Population<T,L> population = mu1_constrained(
+                if(completed.contains(get_csv_line(seed, n, m, mu, run, alpha))) continue;
+                checkpoint_files.push_back(checkpoint_file(checkpoint_directory, get_csv_line(seed, n, m, mu, run, alpha)));
+                times = Component_Times();
+                start_counters();
+                Population_Mu1<G,L> population = mu1_constrained_delta(
                     seed, m, n, mu,
-                    terminate_diversitygenerations(1, true, diversity_measure, n*n*mu), evaluate, mutation_operator, diversity_measure,
-                    alpha, optimal_solution
+                    with_trajectory(terminate_diversitygenerations<G>(1, true, diversity_measure, n*n*mu), recorder, {seed, n, m, mu, run, alpha, algorithm, operator_string}, diversity_value, evaluate),
+                    evaluate, evaluate_tardyjobs_incremental<G>(problem), mutation_operator_delta,
+                    alpha, optimal_solution, checkpoint_files.back(), component_times, lambda, greedy, edge_diversity
                 );
-                result += get_csv_line(seed, n, m, mu, run, population.get_generation(), n*n*mu, diversity_value(population.get_genes(true)), population.get_best_fitness(evaluate), OPT, algorithm, operator_string, alpha);
+                stop_counters();
+                result += with_records(get_csv_line(seed, n, m, mu, run, population.get_generation(), n*n*mu, population.get_diversity(diversity_value), population.get_best_fitness(evaluate), OPT, algorithm, operator_string, alpha), times, performance_counters.get());
+            }
+        }
+        sink.write(result);
+        if(resume){
+            // the results are on disk before the checkpoints they replace are removed
+            sink.checkpoint();
+            for(const std::string& file : checkpoint_files) std::filesystem::remove(file);
+        }
+    };
+
+    auto pending = [&completed, algorithm, alphas](int mu, int n, int m, int run) -> bool {
+        return !run_completed(completed, algorithm, alphas, mu, n, m, run);
+    };
+    loop_parameters(mus, ns, ms, runs, algorithm_test, true, shard, pending);
+}
+
+/*
+    Same as test_algorithm for "Mu1-unconst" and "Mu1-const", running the statically composed Population_Static with the mutation policy mutate
+    (resume skips the completed results, but interrupted runs start over, as Population_Static is not checkpointed)
+*/
+template <typename G, typename Mutation>
+void test_algorithm_static(std::vector<int> mus, std::vector<int> ns, std::vector<int> ms, std::vector<double> alphas, int runs, std::string output_file, std::string algorithm, std::string operator_string, Mutation mutate, bool resume = false, Shard shard = {}){
+   
+    std::string header = "seed,n,m,mu,run,generations,max_generations,diversity,fitness,opt,algorithm,mutation";
+    header += algorithm == "Mu1-const" ? ",alpha\n" : "\n";
+    Completed_Results completed = resume ? Completed_Results(output_file, result_key_columns(algorithm)) : Completed_Results();
+    Result_Sink sink(output_file, resume);
+    if(!completed.has_header()) sink.write(header);
+    std::string checkpoint_directory = resume ? output_file + ".checkpoints" : "";
+    if(resume) std::filesystem::create_directories(checkpoint_directory);
+    int max_processing_time = 50;
+
+    auto algorithm_test = [&sink, &completed, resume, max_processing_time, algorithm, mutate, alphas, operator_string](int mu, int n, int m, int run) {
+
+        if(!is_viable_combination(mu, n, m)) return;
+        // memory of pooled gene layouts, released at the end of the run
+        Gene_Pool_Scope gene_pool(mu, n, m);
+
+        int seed = generate_seed(mu, n, m, run);
+        Instance instance = get_instance(seed, n, max_processing_time, m);
+        MachineSchedulingProblem problem = instance.problem;
+        auto [evaluate, diversity_measure, diversity_value] = get_eval_div_funcs<G>(problem);
+        auto [OPT, optimal_solution] = get_optimal_solution<G>(instance);
+        Terminate_DiversityGenerations<G> termination{1, true, n*n*mu, diversity_value};
+        std::string result;
+        if(algorithm == "Mu1-unconst"){
+            auto population = mu1_unconstrained_static<G>(seed, m, n, mu, termination, mutate);
+            result += get_csv_line(seed, n, m, mu, run, population.get_generation(), n*n*mu, population.get_diversity(diversity_value), population.get_best_fitness(evaluate), OPT, algorithm, operator_string);
+        }else if(algorithm == "Mu1-const"){
+            for(double alpha: alphas){
+                if(completed.contains(get_csv_line(seed, n, m, mu, run, alpha))) continue;
+                auto population = mu1_constrained_static<G>(seed, m, n, mu, termination, Evaluate_TardyJobs<G>{problem}, mutate, alpha, optimal_solution);
+                result += get_csv_line(seed, n, m, mu, run, population.get_generation(), n*n*mu, population.get_diversity(diversity_value), population.get_best_fitness(evaluate), OPT, algorithm, operator_string, alpha);
             }
         }
-        write_to_file(result, output_file);
+        sink.write(result);
+        if(resume) sink.checkpoint();
+    };
+
+    auto pending = [&completed, algorithm, alphas](int mu, int n, int m, int run) -> bool {
+        return !run_completed(completed, algorithm, alphas, mu, n, m, run);
     };
+    loop_parameters(mus, ns, ms, runs, algorithm_test, true, shard, pending);
+}
+
+/*
+    Builds the instance cache file for all viable runs of the grid, keeping the instances already in file if it exists,
+    so one file can serve several grids (instances whose reference schedule stems from another solver or time limit are computed again)
+*/
+void build_instance_cache(std::vector<int> mus, std::vector<int> ns, std::vector<int> ms, int runs, std::string file){
+
+    int max_processing_time = 50;
+    std::vector<Instance> instances;
+    std::set<std::tuple<int, int, int, int>> keys;
+    if(std::filesystem::exists(file)){
+        Instance_Cache cache;
+        cache.open(file);
+        instances = cache.instances();
+        instances.erase(std::remove_if(instances.begin(), instances.end(), [](const Instance& instance) { return !reference_matches(instance); }), instances.end());
+        for(const Instance& instance : instances) keys.insert({instance.seed, instance.n, instance.max_processing_time, instance.m});
+    }
+
+    std::map<std::tuple<int, int, int, int>, int> missing;
+    auto viable = [](int mu, int n, int m, int run) -> bool { return is_viable_combination(mu, n, m); };
+    std::vector<Experiment_Cell> cells;
+    for(const Experiment_Cell& cell : enumerate_cells(mus, ns, ms, runs, viable)){
+        std::tuple<int, int, int, int> key = {generate_seed(cell.mu, cell.n, cell.m, cell.run), cell.n, max_processing_time, cell.m};
+        if(keys.count(key) > 0 || missing.count(key) > 0) continue;
+        missing[key] = cells.size();
+        cells.push_back(cell);
+    }
 
-    loop_parameters(mus, ns, ms, runs, algorithm_test);
-}
\ No newline at end of file
+    std::vector<Instance> computed(cells.size());
+    schedule_cells(cells, [&computed, &missing, max_processing_time](int mu, int n, int m, int run) {
+        int seed = generate_seed(mu, n, m, run);
+        computed[missing.at({seed, n, max_processing_time, m})] = compute_instance(seed, n, max_processing_time, m);
+    });
+
+    instances.insert(instances.end(), computed.begin(), computed.end());
+    write_instance_cache(file, instances);
+}